@@ -9,6 +9,12 @@ AddTarget(TYPE [ MERNEL_BUILD_SHARED ? shared : static ] NAME MernelPlatform
     EXPORT_PARENT_INCLUDES
     LINK_LIBRARIES rapidjson zlib zstd_static)
 
+option( MERNEL_PROPERTY_TREE_FLAT_MAP "Store PropertyTree maps as sorted vectors; inserts invalidate references" OFF )
+mark_as_advanced(MERNEL_PROPERTY_TREE_FLAT_MAP)
+if (MERNEL_PROPERTY_TREE_FLAT_MAP)
+    target_compile_definitions(MernelPlatform PUBLIC MERNEL_PROPERTY_TREE_FLAT_MAP)
+endif()
+
 if (MERNEL_PLATFORM_ONLY)
     return()
 endif()
@@ -22,3 +28,23 @@ AddTarget(TYPE static NAME MernelReflection
 AddTarget(TYPE [ MERNEL_BUILD_SHARED ? shared : static ] NAME MernelExecution
     SOURCE_DIR ${CMAKE_CURRENT_LIST_DIR}/src/MernelExecution
     EXPORT_PARENT_INCLUDES)
+
+option( MERNEL_BUILD_TESTS "Build unit tests and benchmarks for mernel" OFF )
+mark_as_advanced(MERNEL_BUILD_TESTS)
+
+if (MERNEL_BUILD_TESTS)
+    enable_testing()
+
+    AddTarget(TYPE app_console NAME MernelTests
+        SOURCE_DIR ${CMAKE_CURRENT_LIST_DIR}/test/MernelTests
+        SKIP_STATIC_CHECK
+        SKIP_INSTALL
+        LINK_LIBRARIES MernelReflection MernelPlatform MernelExecution gtest_main)
+    add_test(NAME MernelTests COMMAND MernelTests)
+
+    AddTarget(TYPE app_console NAME MernelBenchmarks
+        SOURCE_DIR ${CMAKE_CURRENT_LIST_DIR}/test/MernelBenchmarks
+        SKIP_STATIC_CHECK
+        SKIP_INSTALL
+        LINK_LIBRARIES MernelReflection MernelPlatform MernelExecution rapidjson)
+endif()
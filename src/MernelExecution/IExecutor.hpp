@@ -6,6 +6,7 @@
 #pragma once
 
 #include <atomic>
+#include <vector>
 
 #include "ITaskQueue.hpp"
 
@@ -43,4 +44,12 @@ private:
     std::atomic_bool m_isAborted{ false };
 };
 
+/// Add tasks to the queue and block until executor completes all of them.
+inline IExecutor::Result execTasks(ITaskQueue& taskQueue, IExecutor& executor, std::vector<ITaskQueue::Task> tasks)
+{
+    for (auto& task : tasks)
+        taskQueue.addTask(std::move(task));
+    return executor.execQueue(taskQueue);
+}
+
 }
@@ -8,12 +8,14 @@
 
 #include <cstddef>
 #include <cstring>
+#include <span>
 #include <sstream>
+#include <stdexcept>
 
 namespace Mernel {
 
 /// Class wraps some blob data to use in read/write operations in ByteOrderStream.
-/// Uses ByteArrayHolder as internal storage
+/// Uses ByteArrayHolder as internal storage, or read-only view of external memory.
 class ByteOrderBuffer {
 public:
     ByteOrderBuffer(const ByteArrayHolder& holder = ByteArrayHolder())
@@ -24,6 +26,17 @@ public:
         reset();
     }
 
+    /// Read-only buffer over memory it does not own (e.g. MappedFile::data()), no copy is made.
+    /// Memory must outlive the buffer; any write throws, buffer can't be resized.
+    explicit ByteOrderBuffer(std::span<const uint8_t> view)
+        : m_beg(const_cast<uint8_t*>(view.data()))
+        , m_size(static_cast<ptrdiff_t>(view.size()))
+        , m_resizeEnabled(false)
+        , m_readOnly(true)
+    {}
+
+    bool isReadOnly() const { return m_readOnly; }
+
     ByteArrayHolder&       getHolder() { return m_internal; }
     const ByteArrayHolder& getHolder() const { return m_internal; }
 
@@ -46,6 +59,8 @@ public:
     /// return pointer to current write position, ensuring that buffer have required bytes after that. If possible, buffer grows.
     inline uint8_t* posWrite(size_t required = 0)
     {
+        if (m_readOnly)
+            throw std::runtime_error("Write to read-only buffer");
         ptrdiff_t r = getRemainWrite();
         if (r < ptrdiff_t(required) && !setSize(getSize() + required - r))
             throw std::runtime_error("EOF write buffer reached on offset: " + std::to_string(getOffsetWrite() + required));
@@ -127,8 +142,10 @@ public:
     {
         if (!sz)
             return false;
-        if (sz >= getSize())
+        if (sz >= getSize() && !m_readOnly)
             return setSize(0);
+        if (sz > getSize())
+            sz = getSize();
 
         removeFromStartInternal(sz);
 
@@ -137,7 +154,7 @@ public:
 
     void setResizeEnabled(bool state)
     {
-        m_resizeEnabled = state;
+        m_resizeEnabled = state && !m_readOnly;
     }
 
     /// debugging functions.
@@ -228,8 +245,12 @@ private:
         if (oWrite < 0)
             oWrite = 0;
 
-        m_internal.ref().erase(m_internal.ref().begin(), m_internal.ref().begin() + rem);
-        m_beg  = m_internal.data();
+        if (m_readOnly) {
+            m_beg += rem;
+        } else {
+            m_internal.ref().erase(m_internal.ref().begin(), m_internal.ref().begin() + rem);
+            m_beg = m_internal.data();
+        }
         m_size = oSize;
         setOffsetRead(oRead);
         setOffsetWrite(oWrite);
@@ -245,6 +266,7 @@ private:
     bool m_eofRead       = false;
     bool m_eofWrite      = false;
     bool m_resizeEnabled = true;
+    bool m_readOnly      = false;
 };
 
 }
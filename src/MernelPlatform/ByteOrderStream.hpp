@@ -8,11 +8,32 @@
 #include "ByteOrderStream_macro.hpp"
 #include "ByteOrderBuffer.hpp"
 
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
 #include <deque>
 #include <map>
+#include <span>
+#include <string_view>
 #include <type_traits>
 #include <limits>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MERNEL_BYTEORDER_AVX2
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <tmmintrin.h>
+#define MERNEL_BYTEORDER_SSSE3
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MERNEL_BYTEORDER_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MERNEL_BYTEORDER_NEON
+#endif
+
 namespace Mernel {
 class ByteOrderDataStreamReader;
 class ByteOrderDataStreamWriter;
@@ -43,6 +64,180 @@ concept HasGlobalWrite = requires(T t, ByteOrderDataStreamWriter& writer) {
                              writeBinary(writer, t);
                          };
 
+class ByteOrderReadCursor;
+class ByteOrderWriteCursor;
+/// Records of fixed binary size: whole record is reserved with one bounds check, then fields are streamed through unchecked cursor.
+template<class T>
+concept HasFixedSizeRead = requires(T t, ByteOrderReadCursor& cursor) {
+                               { T::s_binarySize } -> std::convertible_to<size_t>;
+                               t.readBinary(cursor);
+                           };
+template<class T>
+concept HasFixedSizeWrite = requires(const T t, ByteOrderWriteCursor& cursor) {
+                                { T::s_binarySize } -> std::convertible_to<size_t>;
+                                t.writeBinary(cursor);
+                            };
+
+/// Arithmetic types in contiguous containers are streamed in bulk: one bounds check and one copy for the whole array.
+template<class T>
+concept BulkStreamable = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+namespace details {
+
+/// Reverses byte order of each of count elements. Ranges must not overlap.
+template<size_t size>
+inline void reverseBytes(uint8_t* dst, const uint8_t* src, size_t count) noexcept
+{
+    static_assert(size == 2 || size == 4 || size == 8);
+    const size_t bytes = count * size;
+    size_t       pos   = 0;
+#if defined(MERNEL_BYTEORDER_SSSE3)
+    // one shuffle reverses every element inside a 16-byte block.
+    constexpr auto s_shuffle = [] {
+        std::array<uint8_t, 16> result{};
+        for (size_t i = 0; i < 16; ++i)
+            result[i] = static_cast<uint8_t>(i / size * size + size - 1 - i % size);
+        return result;
+    }();
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s_shuffle.data()));
+#if defined(MERNEL_BYTEORDER_AVX2)
+    const __m256i shuffle256 = _mm256_broadcastsi128_si256(shuffle);
+    for (; pos + 32 <= bytes; pos += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + pos));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + pos), _mm256_shuffle_epi8(block, shuffle256));
+    }
+#endif
+    for (; pos + 16 <= bytes; pos += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pos), _mm_shuffle_epi8(block, shuffle));
+    }
+#elif defined(MERNEL_BYTEORDER_SSE2)
+    for (; pos + 16 <= bytes; pos += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+        // swap bytes in 16-bit words, then reverse words inside an element.
+        block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+        if constexpr (size == 4)
+            block = _mm_shufflehi_epi16(_mm_shufflelo_epi16(block, 0xB1), 0xB1);
+        if constexpr (size == 8)
+            block = _mm_shufflehi_epi16(_mm_shufflelo_epi16(block, 0x1B), 0x1B);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pos), block);
+    }
+#elif defined(MERNEL_BYTEORDER_NEON)
+    for (; pos + 16 <= bytes; pos += 16) {
+        uint8x16_t block = vld1q_u8(src + pos);
+        if constexpr (size == 2)
+            block = vrev16q_u8(block);
+        if constexpr (size == 4)
+            block = vrev32q_u8(block);
+        if constexpr (size == 8)
+            block = vrev64q_u8(block);
+        vst1q_u8(dst + pos, block);
+    }
+#endif
+    for (; pos < bytes; pos += size) {
+        for (size_t i = 0; i < size; ++i)
+            dst[pos + i] = src[pos + size - 1 - i];
+    }
+}
+
+inline uint16_t byteSwap(uint16_t value) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _byteswap_ushort(value);
+#else
+    return __builtin_bswap16(value);
+#endif
+}
+inline uint32_t byteSwap(uint32_t value) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _byteswap_ulong(value);
+#else
+    return __builtin_bswap32(value);
+#endif
+}
+inline uint64_t byteSwap(uint64_t value) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _byteswap_uint64(value);
+#else
+    return __builtin_bswap64(value);
+#endif
+}
+
+template<size_t size>
+struct UnsignedOfSize;
+template<>
+struct UnsignedOfSize<1> {
+    using Type = uint8_t;
+};
+template<>
+struct UnsignedOfSize<2> {
+    using Type = uint16_t;
+};
+template<>
+struct UnsignedOfSize<4> {
+    using Type = uint32_t;
+};
+template<>
+struct UnsignedOfSize<8> {
+    using Type = uint64_t;
+};
+
+/// Unaligned load of scalar stored in order; byte swap is done only if order is not native.
+template<std::endian order, class T>
+inline T loadScalar(const uint8_t* buffer) noexcept
+{
+    using Raw = typename UnsignedOfSize<sizeof(T)>::Type;
+    Raw raw;
+    std::memcpy(&raw, buffer, sizeof(T));
+    if constexpr (sizeof(T) > 1 && order != std::endian::native)
+        raw = byteSwap(raw);
+    return std::bit_cast<T>(raw);
+}
+
+template<std::endian order, class T>
+inline void storeScalar(uint8_t* buffer, T value) noexcept
+{
+    using Raw = typename UnsignedOfSize<sizeof(T)>::Type;
+    Raw raw   = std::bit_cast<Raw>(value);
+    if constexpr (sizeof(T) > 1 && order != std::endian::native)
+        raw = byteSwap(raw);
+    std::memcpy(buffer, &raw, sizeof(T));
+}
+
+/// Places byte i of source at (i ^ mask) of destination; the same permutation serves both read and write.
+template<size_t size>
+inline void permuteBytes(uint8_t* dst, const uint8_t* src, uint_fast8_t mask) noexcept
+{
+    for (size_t i = 0; i < size; ++i)
+        dst[mask ^ i] = src[i];
+}
+
+/// Copies count elements, placing byte i of source element at (i ^ mask) of destination - same permutation as read<size>/write<size>.
+template<size_t size>
+inline void copyWithMask(uint8_t* dst, const uint8_t* src, size_t count, uint_fast8_t mask) noexcept
+{
+    if (!count)
+        return;
+    if (mask == 0) {
+        std::memcpy(dst, src, count * size);
+        return;
+    }
+    if constexpr (size > 1) {
+        if (mask == size - 1) {
+            reverseBytes<size>(dst, src, count);
+            return;
+        }
+    }
+    for (size_t pos = 0; pos < count * size; pos += size) {
+        for (size_t i = 0; i < size; ++i)
+            dst[pos + (mask ^ i)] = src[pos + i];
+    }
+}
+
+}
+
 inline constexpr uint_fast8_t createByteorderMask(uint_fast8_t endiannes8, uint_fast8_t endiannes16, uint_fast8_t endiannes32)
 {
     return endiannes8 | (endiannes16 << 1) | (endiannes32 << 2);
@@ -136,6 +331,146 @@ protected:
     void*            m_userData = nullptr;
 };
 
+/**
+ * @brief Unchecked sequential reading from a range reserved in stream with a single bounds check.
+ *
+ * Created by ByteOrderDataStreamReader::reserveRead(); stream read position moves by the bytes consumed when cursor is destroyed.
+ * Reading beyond the reserved range is a programming error (checked by assert only).
+ *
+ * struct Point {
+ *     static constexpr size_t s_binarySize = 8;
+ *     int32_t x, y;
+ *     void readBinary(ByteOrderReadCursor& cursor) { cursor >> x >> y; }
+ * };
+ */
+class ByteOrderReadCursor {
+public:
+    ByteOrderReadCursor(ByteOrderDataStream& stream, size_t size)
+        : m_stream(stream)
+        , m_begin(stream.getBuffer().posRead(size))
+        , m_pos(m_begin)
+        , m_end(m_begin + size)
+    {}
+    ~ByteOrderReadCursor() { m_stream.getBuffer().markRead(m_pos - m_begin); }
+
+    ByteOrderReadCursor(const ByteOrderReadCursor&)            = delete;
+    ByteOrderReadCursor& operator=(const ByteOrderReadCursor&) = delete;
+
+    size_t remaining() const { return m_end - m_pos; }
+
+    template<typename T>
+    requires std::is_arithmetic_v<T>
+    inline ByteOrderReadCursor& operator>>(T& data)
+    {
+        assert(remaining() >= sizeof(T));
+        details::permuteBytes<sizeof(T)>(reinterpret_cast<uint8_t*>(&data), m_pos, m_stream.getTypeMask<T>());
+        m_pos += sizeof(T);
+        return *this;
+    }
+    template<class T>
+    inline T readScalar()
+    {
+        T ret = T();
+        *this >> ret;
+        return ret;
+    }
+
+    inline ByteOrderReadCursor& operator>>(HasFixedSizeRead auto& data)
+    {
+        data.readBinary(*this);
+        return *this;
+    }
+
+    template<size_t size>
+    inline ByteOrderReadCursor& operator>>(std::array<uint8_t, size>& data)
+    {
+        readBlock(data.data(), size);
+        return *this;
+    }
+
+    void readBlock(uint8_t* data, size_t size)
+    {
+        assert(remaining() >= size);
+        std::memcpy(data, m_pos, size);
+        m_pos += size;
+    }
+    void zeroPadding(size_t size)
+    {
+        assert(remaining() >= size);
+        m_pos += size;
+    }
+
+private:
+    ByteOrderDataStream& m_stream;
+    const uint8_t* const m_begin;
+    const uint8_t*       m_pos;
+    const uint8_t* const m_end;
+};
+
+/**
+ * @brief Unchecked sequential writing into a range reserved in stream (buffer grows once).
+ *
+ * Created by ByteOrderDataStreamWriter::reserveWrite(); stream write position moves by the bytes written when cursor is destroyed.
+ * Stream must not be written directly while cursor is alive, as growing the buffer invalidates the reserved range.
+ */
+class ByteOrderWriteCursor {
+public:
+    ByteOrderWriteCursor(ByteOrderDataStream& stream, size_t size)
+        : m_stream(stream)
+        , m_begin(stream.getBuffer().posWrite(size))
+        , m_pos(m_begin)
+        , m_end(m_begin + size)
+    {}
+    ~ByteOrderWriteCursor() { m_stream.getBuffer().markWrite(m_pos - m_begin); }
+
+    ByteOrderWriteCursor(const ByteOrderWriteCursor&)            = delete;
+    ByteOrderWriteCursor& operator=(const ByteOrderWriteCursor&) = delete;
+
+    size_t remaining() const { return m_end - m_pos; }
+
+    template<typename T>
+    requires std::is_arithmetic_v<T>
+    inline ByteOrderWriteCursor& operator<<(const T& data)
+    {
+        assert(remaining() >= sizeof(T));
+        details::permuteBytes<sizeof(T)>(m_pos, reinterpret_cast<const uint8_t*>(&data), m_stream.getTypeMask<T>());
+        m_pos += sizeof(T);
+        return *this;
+    }
+
+    inline ByteOrderWriteCursor& operator<<(const HasFixedSizeWrite auto& data)
+    {
+        data.writeBinary(*this);
+        return *this;
+    }
+
+    template<size_t size>
+    inline ByteOrderWriteCursor& operator<<(const std::array<uint8_t, size>& data)
+    {
+        writeBlock(data.data(), size);
+        return *this;
+    }
+
+    void writeBlock(const uint8_t* data, size_t size)
+    {
+        assert(remaining() >= size);
+        std::memcpy(m_pos, data, size);
+        m_pos += size;
+    }
+    void zeroPadding(size_t size)
+    {
+        assert(remaining() >= size);
+        std::memset(m_pos, 0, size);
+        m_pos += size;
+    }
+
+private:
+    ByteOrderDataStream& m_stream;
+    uint8_t* const       m_begin;
+    uint8_t*             m_pos;
+    uint8_t* const       m_end;
+};
+
 class ByteOrderDataStreamReader : public ByteOrderDataStream {
 public:
     using ByteOrderDataStream::ByteOrderDataStream;
@@ -178,14 +513,36 @@ public:
         readBinary(*this, data);
         return *this;
     }
+    template<HasFixedSizeRead T>
+    inline ByteOrderDataStreamReader& operator>>(T& data)
+    {
+        ByteOrderReadCursor cursor(*this, T::s_binarySize);
+        data.readBinary(cursor);
+        assert(cursor.remaining() == 0);
+        return *this;
+    }
+
+    /// Checks that size bytes are available; fields inside them are read through the cursor without further checks.
+    ByteOrderReadCursor reserveRead(size_t size)
+    {
+        return ByteOrderReadCursor(*this, size);
+    }
 
     template<typename T>
     inline ByteOrderDataStreamReader& operator>>(std::vector<T>& data)
     {
         auto size = readSize();
         data.resize(size);
-        for (auto& element : data)
-            *this >> element;
+        if constexpr (BulkStreamable<T>) {
+            readArray(data.data(), data.size());
+        } else if constexpr (HasFixedSizeRead<T>) {
+            ByteOrderReadCursor cursor(*this, data.size() * T::s_binarySize);
+            for (auto& element : data)
+                element.readBinary(cursor);
+        } else {
+            for (auto& element : data)
+                *this >> element;
+        }
         return *this;
     }
 
@@ -220,17 +577,58 @@ public:
         return *this;
     }
 
+    /// Reads count scalars at once; equivalent to reading them one by one with operator>>.
+    template<BulkStreamable T>
+    void readArray(T* data, size_t count)
+    {
+        const size_t   size    = count * sizeof(T);
+        const uint8_t* bufferP = m_buf.posRead(size);
+        details::copyWithMask<sizeof(T)>(reinterpret_cast<uint8_t*>(data), bufferP, count, this->getTypeMask<T>());
+        m_buf.markRead(size);
+    }
+
     std::string readPascalString()
     {
         auto size = readSize();
         if (this->eofRead())
             return {};
 
-        std::string str;
-        str.resize(size);
-        readBlock((uint8_t*) str.data(), size);
+        return std::string(readStringView(size));
+    }
 
-        return eofRead() ? std::string{} : str;
+    /// Zero-copy reads: views point into the stream buffer and stay valid while its storage is alive and not resized
+    /// (e.g. ByteOrderBuffer over MappedFile, or a loaded holder).
+    std::string_view readPascalStringView()
+    {
+        return readStringView(readSize());
+    }
+    std::string_view readStringView(size_t size)
+    {
+        const auto block = readBlockView(size);
+        return { reinterpret_cast<const char*>(block.data()), block.size() };
+    }
+    std::span<const uint8_t> readBlockView(size_t size)
+    {
+        const uint8_t* start = m_buf.posRead(size);
+        m_buf.markRead(size);
+        return { start, size };
+    }
+
+    /// Size-prefixed array as written by operator<<(std::vector<T>), as a view if stream order is host order and data is aligned for T.
+    /// Otherwise returns false and leaves stream position unchanged; then read it into std::vector.
+    template<BulkStreamable T>
+    bool readArrayView(std::span<const T>& data)
+    {
+        const ptrdiff_t offset = m_buf.getOffsetRead();
+        const size_t    size   = readSize();
+        const uint8_t*  start  = m_buf.posRead(size * sizeof(T));
+        if (this->getTypeMask<T>() != 0 || reinterpret_cast<uintptr_t>(start) % alignof(T) != 0) {
+            m_buf.setOffsetRead(offset);
+            return false;
+        }
+        m_buf.markRead(size * sizeof(T));
+        data = { reinterpret_cast<const T*>(start), size };
+        return true;
     }
     void readBlock(uint8_t* data, ptrdiff_t size)
     {
@@ -247,12 +645,10 @@ public:
     template<size_t strSize>
     void readStringWithGarbagePadding(std::string& str, std::vector<uint8_t>& strGarbagePadding)
     {
-        std::array<char, strSize + 1> strBuffer{};
-        this->readBlock(strBuffer.data(), strSize);
-        str = strBuffer.data();
-        if (str.size() < strSize - 1) {
-            strGarbagePadding.resize(strSize - str.size() - 1);
-            std::memcpy(strGarbagePadding.data(), strBuffer.data() + str.size() + 1, strGarbagePadding.size());
+        const std::string_view block = readStringView(strSize);
+        str.assign(block.substr(0, block.find('\0')));
+        if (str.size() + 1 < strSize) {
+            strGarbagePadding.assign(block.begin() + str.size() + 1, block.end());
             while (!strGarbagePadding.empty() && (*strGarbagePadding.rbegin() == 0))
                 strGarbagePadding.pop_back();
         }
@@ -344,8 +740,16 @@ public:
     inline ByteOrderDataStreamWriter& operator<<(const std::vector<T>& data)
     {
         writeSize(data.size());
-        for (const auto& element : data)
-            *this << element;
+        if constexpr (BulkStreamable<T>) {
+            writeArray(data.data(), data.size());
+        } else if constexpr (HasFixedSizeWrite<T>) {
+            ByteOrderWriteCursor cursor(*this, data.size() * T::s_binarySize);
+            for (const auto& element : data)
+                element.writeBinary(cursor);
+        } else {
+            for (const auto& element : data)
+                *this << element;
+        }
         return *this;
     }
     template<typename T>
@@ -381,6 +785,20 @@ public:
         writeBinary(*this, data);
         return *this;
     }
+    template<HasFixedSizeWrite T>
+    inline ByteOrderDataStreamWriter& operator<<(const T& data)
+    {
+        ByteOrderWriteCursor cursor(*this, T::s_binarySize);
+        data.writeBinary(cursor);
+        assert(cursor.remaining() == 0);
+        return *this;
+    }
+
+    /// Grows buffer for size bytes at once; fields are written through the cursor without further checks.
+    ByteOrderWriteCursor reserveWrite(size_t size)
+    {
+        return ByteOrderWriteCursor(*this, size);
+    }
 
     template<size_t size>
     inline ByteOrderDataStreamWriter& operator<<(const std::array<uint8_t, size>& data)
@@ -392,6 +810,16 @@ public:
     template<typename T>
     inline void writeToOffset(const T& data, ptrdiff_t writeOffset);
 
+    /// Writes count scalars at once; equivalent to writing them one by one with operator<<.
+    template<BulkStreamable T>
+    void writeArray(const T* data, size_t count)
+    {
+        const size_t size    = count * sizeof(T);
+        uint8_t*     bufferP = m_buf.posWrite(size);
+        details::copyWithMask<sizeof(T)>(bufferP, reinterpret_cast<const uint8_t*>(data), count, this->getTypeMask<T>());
+        m_buf.markWrite(size);
+    }
+
     /// Read/write strings with size.
     void writePascalString(const std::string& str)
     {
@@ -602,12 +1030,106 @@ inline ByteOrderDataStreamReader& ByteOrderDataStreamReader::operator>>(std::str
     return *this;
 }
 template<>
+inline ByteOrderDataStreamReader& ByteOrderDataStreamReader::operator>>(std::string_view& data)
+{
+    data = readPascalStringView();
+    return *this;
+}
+template<>
 inline ByteOrderDataStreamWriter& ByteOrderDataStreamWriter::operator<<(const std::string& data)
 {
     writePascalString(data);
     return *this;
 }
 
+/// Scalars for which compile-time order is just native order or plain byte swap.
+/// Floating point on hosts with mixed-endian doubles keeps the runtime mask path.
+template<class T>
+concept FixedOrderStreamable = BulkStreamable<T>
+                               && (std::is_integral_v<T>
+                                   || (HOST_BYTE_ORDER_FLOAT == HOST_BYTE_ORDER_INT
+                                       && HOST_WORD_ORDER_FLOAT == HOST_WORD_ORDER_INT
+                                       && HOST_DWORD_ORDER_DOUBLE == HOST_DWORD_ORDER_INT64));
+
+/**
+ * @brief Reader with byte order fixed at compile time.
+ *
+ * Scalar reads are an unaligned load plus byte swap for the foreign order, without per-byte mask permutation.
+ * It is still a ByteOrderDataStreamReader, so readBinary() of user types works as usual (through the runtime mask).
+ * Use base ByteOrderDataStreamReader for formats with mixed byte and word orders.
+ *
+ * ByteOrderDataStreamReaderLE stream(buffer);
+ * stream >> header.m_version >> header.m_entries;
+ */
+template<std::endian order>
+class ByteOrderDataStreamReaderT : public ByteOrderDataStreamReader {
+    static_assert(order == std::endian::little || order == std::endian::big);
+    static_assert(std::endian::native == std::endian::little || std::endian::native == std::endian::big, "Mixed-endian host is not supported");
+
+public:
+    explicit ByteOrderDataStreamReaderT(ByteOrderBuffer& buf)
+        : ByteOrderDataStreamReader(buf, order == std::endian::big ? s_bigEndian : s_littleEndian)
+    {}
+
+    template<typename T>
+    inline ByteOrderDataStreamReaderT& operator>>(T& data)
+    {
+        if constexpr (FixedOrderStreamable<T>) {
+            const uint8_t* bufferP = m_buf.posRead(sizeof(T));
+            data                   = details::loadScalar<order, T>(bufferP);
+            m_buf.markRead(sizeof(T));
+        } else {
+            ByteOrderDataStreamReader::operator>>(data);
+        }
+        return *this;
+    }
+
+    template<class T>
+    inline T readScalar()
+    {
+        T ret = T();
+        *this >> ret;
+        return ret;
+    }
+
+private:
+    // mask must match template order.
+    using ByteOrderDataStream::setMask;
+};
+
+/// Writer counterpart of ByteOrderDataStreamReaderT.
+template<std::endian order>
+class ByteOrderDataStreamWriterT : public ByteOrderDataStreamWriter {
+    static_assert(order == std::endian::little || order == std::endian::big);
+    static_assert(std::endian::native == std::endian::little || std::endian::native == std::endian::big, "Mixed-endian host is not supported");
+
+public:
+    explicit ByteOrderDataStreamWriterT(ByteOrderBuffer& buf)
+        : ByteOrderDataStreamWriter(buf, order == std::endian::big ? s_bigEndian : s_littleEndian)
+    {}
+
+    template<typename T>
+    inline ByteOrderDataStreamWriterT& operator<<(const T& data)
+    {
+        if constexpr (FixedOrderStreamable<T>) {
+            uint8_t* bufferP = m_buf.posWrite(sizeof(T));
+            details::storeScalar<order, T>(bufferP, data);
+            m_buf.markWrite(sizeof(T));
+        } else {
+            ByteOrderDataStreamWriter::operator<<(data);
+        }
+        return *this;
+    }
+
+private:
+    using ByteOrderDataStream::setMask;
+};
+
+using ByteOrderDataStreamReaderLE = ByteOrderDataStreamReaderT<std::endian::little>;
+using ByteOrderDataStreamReaderBE = ByteOrderDataStreamReaderT<std::endian::big>;
+using ByteOrderDataStreamWriterLE = ByteOrderDataStreamWriterT<std::endian::little>;
+using ByteOrderDataStreamWriterBE = ByteOrderDataStreamWriterT<std::endian::big>;
+
 template<typename T>
 void ByteOrderDataStreamWriter::writeToOffset(const T& data, ptrdiff_t writeOffset)
 {
@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "FileFormatBinaryTree.hpp"
+
+#include "ByteOrderStream.hpp"
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace Mernel {
+
+namespace {
+
+enum class Tag : uint8_t
+{
+    Null,
+    False,
+    True,
+    Int,
+    Double,
+    String,
+    List,
+    Map,
+};
+
+constexpr char     s_magic[4]   = { 'M', 'P', 'T', 'B' };
+constexpr uint32_t s_version    = 1;
+constexpr size_t   s_headerSize = sizeof(s_magic) + sizeof(uint32_t) * 2;
+
+class BinaryTreeWriter {
+public:
+    explicit BinaryTreeWriter(ByteOrderBuffer& buffer)
+        : m_stream(buffer, ByteOrderDataStream::s_littleEndian)
+        , m_base(buffer.getOffsetWrite())
+    {}
+
+    void write(const PropertyTree& data)
+    {
+        m_stream.writeBlock(s_magic, sizeof(s_magic));
+        m_stream << s_version;
+        const ptrdiff_t rootPos = m_stream.getBuffer().getOffsetWrite();
+        m_stream << uint32_t(0);
+
+        const uint32_t root = writeNode(data);
+        m_stream.writeToOffset(root, rootPos);
+    }
+
+private:
+    uint32_t offset() const
+    {
+        const ptrdiff_t result = m_stream.getBuffer().getOffsetWrite() - m_base;
+        if (result > ptrdiff_t(UINT32_MAX))
+            throw std::runtime_error("Binary tree exceeds 4GB");
+        return static_cast<uint32_t>(result);
+    }
+
+    void writeTag(Tag tag) { m_stream << static_cast<uint8_t>(tag); }
+
+    void writeVarint(uint64_t value)
+    {
+        while (value >= 0x80) {
+            m_stream << static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        m_stream << static_cast<uint8_t>(value);
+    }
+
+    uint32_t writeString(std::string_view value)
+    {
+        const uint32_t result = offset();
+        writeTag(Tag::String);
+        writeVarint(value.size());
+        m_stream.writeBlock(value.data(), value.size());
+        m_stream << uint8_t(0);
+        return result;
+    }
+
+    uint32_t writeKey(std::string_view key)
+    {
+        auto it = m_keys.find(key);
+        if (it != m_keys.end())
+            return it->second;
+        const uint32_t result = writeString(key);
+        m_keys[key]           = result;
+        return result;
+    }
+
+    uint32_t writeNode(const PropertyTree& data)
+    {
+        if (data.isList()) {
+            const auto&           list = data.getList();
+            std::vector<uint32_t> children;
+            children.reserve(list.size());
+            for (const PropertyTree& child : list)
+                children.push_back(writeNode(child));
+
+            const uint32_t result = offset();
+            writeTag(Tag::List);
+            writeVarint(children.size());
+            for (uint32_t child : children)
+                m_stream << child;
+            return result;
+        }
+        if (data.isMap()) {
+            const auto&                                map = data.getMap();
+            std::vector<std::pair<uint32_t, uint32_t>> children;
+            children.reserve(map.size());
+            for (const auto& [key, child] : map) {
+                const uint32_t keyOffset = writeKey(key.view());
+                children.emplace_back(keyOffset, writeNode(child));
+            }
+
+            const uint32_t result = offset();
+            writeTag(Tag::Map);
+            writeVarint(children.size());
+            for (const auto& [keyOffset, valueOffset] : children)
+                m_stream << keyOffset << valueOffset;
+            return result;
+        }
+        if (!data.isScalar()) {
+            const uint32_t result = offset();
+            writeTag(Tag::Null);
+            return result;
+        }
+
+        const PropertyTreeScalar& scalar = data.getScalar();
+        if (scalar.isString())
+            return writeString(scalar.toStringView());
+
+        const uint32_t result = offset();
+        if (scalar.isBool()) {
+            writeTag(scalar.toBool() ? Tag::True : Tag::False);
+        } else if (scalar.isInt()) {
+            const int64_t value = scalar.toInt();
+            writeTag(Tag::Int);
+            writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        } else if (scalar.isDouble()) {
+            writeTag(Tag::Double);
+            m_stream << scalar.toDouble();
+        } else {
+            writeTag(Tag::Null);
+        }
+        return result;
+    }
+
+    ByteOrderDataStreamWriter                      m_stream;
+    const ptrdiff_t                                m_base;
+    std::unordered_map<std::string_view, uint32_t> m_keys;
+};
+
+// bounds-checked little-endian access to the buffer.
+class NodeReader {
+public:
+    NodeReader(const uint8_t* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+    {}
+
+    void check(size_t pos, size_t count) const
+    {
+        if (pos > m_size || count > m_size - pos)
+            throw std::runtime_error("Binary tree: offset is out of range");
+    }
+
+    Tag tag(size_t pos) const
+    {
+        check(pos, 1);
+        const uint8_t value = m_data[pos];
+        if (value > static_cast<uint8_t>(Tag::Map))
+            throw std::runtime_error("Binary tree: invalid node tag " + std::to_string(value));
+        return static_cast<Tag>(value);
+    }
+
+    uint64_t loadLE(size_t pos, size_t bytes) const
+    {
+        check(pos, bytes);
+        uint64_t result = 0;
+        for (size_t i = 0; i < bytes; ++i)
+            result |= uint64_t(m_data[pos + i]) << (8 * i);
+        return result;
+    }
+
+    uint32_t u32(size_t pos) const { return static_cast<uint32_t>(loadLE(pos, 4)); }
+
+    // children and keys are written before their parent, so offsets strictly decrease down the tree; this also rules out cycles.
+    uint32_t childOffset(size_t pos, uint32_t parent) const
+    {
+        const uint32_t result = u32(pos);
+        if (result < s_headerSize || result >= parent)
+            throw std::runtime_error("Binary tree: child offset " + std::to_string(result) + " is not before its parent");
+        return result;
+    }
+
+    uint64_t varint(size_t& pos) const
+    {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            check(pos, 1);
+            const uint8_t byte = m_data[pos++];
+            result |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return result;
+        }
+        throw std::runtime_error("Binary tree: varint is too long");
+    }
+
+    std::string_view string(size_t offset) const
+    {
+        if (tag(offset) != Tag::String)
+            throw std::runtime_error("Binary tree: string expected");
+        size_t       pos  = offset + 1;
+        const size_t size = static_cast<size_t>(varint(pos));
+        check(pos, size + 1);
+        return { reinterpret_cast<const char*>(m_data + pos), size };
+    }
+
+    // returns element count of container node and sets pos to its offset table.
+    size_t container(size_t offset, size_t& pos) const
+    {
+        const Tag t = tag(offset);
+        if (t != Tag::List && t != Tag::Map)
+            return 0;
+        pos                      = offset + 1;
+        const uint64_t count     = varint(pos);
+        const size_t   entrySize = t == Tag::List ? 4 : 8;
+        if (count > (m_size - pos) / entrySize)
+            throw std::runtime_error("Binary tree: offset table is out of range");
+        return static_cast<size_t>(count);
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t         m_size;
+};
+
+}
+
+void writeBinaryTreeToBuffer(ByteOrderBuffer& buffer, const PropertyTree& data) noexcept(false)
+{
+    BinaryTreeWriter writer(buffer);
+    writer.write(data);
+}
+
+PropertyTree readBinaryTreeFromBuffer(std::span<const uint8_t> buffer) noexcept(false)
+{
+    return BinaryTreeView::root(buffer).toPropertyTree();
+}
+
+BinaryTreeView BinaryTreeView::root(std::span<const uint8_t> buffer) noexcept(false)
+{
+    if (buffer.size() < s_headerSize || std::memcmp(buffer.data(), s_magic, sizeof(s_magic)) != 0)
+        throw std::runtime_error("Binary tree: invalid header");
+    if (buffer.size() > UINT32_MAX)
+        throw std::runtime_error("Binary tree: buffer exceeds 4GB");
+
+    NodeReader     reader(buffer.data(), buffer.size());
+    const uint32_t version = reader.u32(sizeof(s_magic));
+    if (version != s_version)
+        throw std::runtime_error("Binary tree: unsupported version " + std::to_string(version));
+
+    const uint32_t rootOffset = reader.u32(sizeof(s_magic) + sizeof(uint32_t));
+    if (rootOffset < s_headerSize)
+        throw std::runtime_error("Binary tree: root offset is inside the header");
+    reader.tag(rootOffset);
+    return BinaryTreeView(buffer.data(), buffer.size(), rootOffset, s_noKey);
+}
+
+uint8_t BinaryTreeView::tag() const noexcept(false)
+{
+    if (!m_data)
+        throw std::runtime_error("Binary tree: invalid view access");
+    return static_cast<uint8_t>(NodeReader(m_data, m_size).tag(m_offset));
+}
+
+bool BinaryTreeView::isNull() const noexcept(false)
+{
+    return tag() == static_cast<uint8_t>(Tag::Null);
+}
+
+bool BinaryTreeView::isScalar() const noexcept(false)
+{
+    const Tag t = static_cast<Tag>(tag());
+    return t != Tag::Null && t != Tag::List && t != Tag::Map;
+}
+
+bool BinaryTreeView::isList() const noexcept(false)
+{
+    return tag() == static_cast<uint8_t>(Tag::List);
+}
+
+bool BinaryTreeView::isMap() const noexcept(false)
+{
+    return tag() == static_cast<uint8_t>(Tag::Map);
+}
+
+size_t BinaryTreeView::size() const noexcept(false)
+{
+    if (!m_data)
+        return 0;
+    size_t pos = 0;
+    return NodeReader(m_data, m_size).container(m_offset, pos);
+}
+
+BinaryTreeView BinaryTreeView::find(std::string_view key) const noexcept(false)
+{
+    if (!isMap())
+        return {};
+
+    const NodeReader reader(m_data, m_size);
+    size_t           table = 0;
+    size_t           lo    = 0;
+    size_t           hi    = reader.container(m_offset, table);
+    while (lo < hi) {
+        const size_t   mid       = lo + (hi - lo) / 2;
+        const uint32_t keyOffset = reader.childOffset(table + mid * 8, m_offset);
+        const auto     cmp       = reader.string(keyOffset) <=> key;
+        if (cmp == 0)
+            return BinaryTreeView(m_data, m_size, reader.childOffset(table + mid * 8 + 4, m_offset), keyOffset);
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return {};
+}
+
+BinaryTreeView BinaryTreeView::operator[](std::string_view key) const noexcept(false)
+{
+    if (!isMap())
+        throw std::runtime_error("Invalid variant access, map expected");
+    BinaryTreeView result = find(key);
+    if (!result.isValid())
+        throw std::out_of_range("BinaryTreeView: key not found");
+    return result;
+}
+
+BinaryTreeView BinaryTreeView::operator[](size_t index) const noexcept(false)
+{
+    if (!isList() && !isMap())
+        throw std::runtime_error("Invalid variant access, list expected");
+    if (index >= size())
+        throw std::out_of_range("BinaryTreeView: index is out of range");
+    return child(index);
+}
+
+BinaryTreeView BinaryTreeView::child(size_t index) const noexcept(false)
+{
+    const NodeReader reader(m_data, m_size);
+    size_t           table = 0;
+    reader.container(m_offset, table);
+    if (isList())
+        return BinaryTreeView(m_data, m_size, reader.childOffset(table + index * 4, m_offset), s_noKey);
+    return BinaryTreeView(m_data, m_size, reader.childOffset(table + index * 8 + 4, m_offset), reader.childOffset(table + index * 8, m_offset));
+}
+
+std::string_view BinaryTreeView::key() const noexcept(false)
+{
+    if (!m_data || m_keyOffset == s_noKey)
+        return {};
+    return NodeReader(m_data, m_size).string(m_keyOffset);
+}
+
+PropertyTreeScalar BinaryTreeView::getScalar(bool borrowString) const noexcept(false)
+{
+    const NodeReader reader(m_data, m_size);
+    switch (static_cast<Tag>(tag())) {
+        case Tag::False:
+            return PropertyTreeScalar(false);
+        case Tag::True:
+            return PropertyTreeScalar(true);
+        case Tag::Int: {
+            size_t         pos   = m_offset + 1;
+            const uint64_t value = reader.varint(pos);
+            return PropertyTreeScalar(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+        }
+        case Tag::Double:
+            return PropertyTreeScalar(std::bit_cast<double>(reader.loadLE(m_offset + 1, 8)));
+        case Tag::String: {
+            const std::string_view value = reader.string(m_offset);
+            return borrowString ? PropertyTreeScalar::borrowed(value) : PropertyTreeScalar(value);
+        }
+        default:
+            break;
+    }
+    throw std::runtime_error("Invalid variant access, scalar expected");
+}
+
+PropertyTree BinaryTreeView::toPropertyTree(bool borrowStrings) const noexcept(false)
+{
+    if (isNull())
+        return {};
+    if (isScalar())
+        return PropertyTree(getScalar(borrowStrings));
+
+    const size_t count = size();
+    if (isList()) {
+        PropertyTreeList list;
+        list.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            list.push_back(child(i).toPropertyTree(borrowStrings));
+        return PropertyTree(std::move(list));
+    }
+    PropertyTreeMap map;
+    map.reserve(count);
+    // keys are already sorted, so sortAppended() only checks the order.
+    for (size_t i = 0; i < count; ++i) {
+        const BinaryTreeView value = child(i);
+        map.appendUnsorted(PropertyTreeKey(value.key())) = value.toPropertyTree(borrowStrings);
+    }
+    map.sortAppended();
+    return PropertyTree(std::move(map));
+}
+
+}
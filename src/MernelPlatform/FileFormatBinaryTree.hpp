@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "PropertyTree.hpp"
+#include "ByteOrderBuffer.hpp"
+
+#include "MernelPlatformExport.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace Mernel {
+
+/**
+ * Binary PropertyTree encoding, suitable for querying in place (e.g. from memory-mapped file).
+ *
+ * All numbers are little-endian. Layout:
+ * header: "MPTB" magic, uint32 version, uint32 offset of root node.
+ * node:   uint8 tag, then payload depending on tag:
+ *   Null, False, True - nothing;
+ *   Int    - zigzag varint;
+ *   Double - 8 bytes;
+ *   String - varint size, bytes, zero byte (so strings can be borrowed, see PropertyTreeScalar::borrowed);
+ *   List   - varint count, count * uint32 child node offset;
+ *   Map    - varint count, count * (uint32 key offset, uint32 value offset), sorted by key. Keys are String nodes, equal keys are stored once.
+ * Offsets are counted from the header start. Children and keys are written before their parent, reader rejects other offsets.
+ */
+MERNELPLATFORM_EXPORT void writeBinaryTreeToBuffer(ByteOrderBuffer& buffer, const PropertyTree& data) noexcept(false);
+
+MERNELPLATFORM_EXPORT PropertyTree readBinaryTreeFromBuffer(std::span<const uint8_t> buffer) noexcept(false);
+
+/**
+ * @brief Read-only reference to a node of binary PropertyTree data, nothing is decoded in advance.
+ *
+ * Lookup in a map is a binary search over its key table, list index is direct access.
+ * Buffer must outlive all views created from it. Malformed data throws std::runtime_error on access.
+ */
+class MERNELPLATFORM_EXPORT BinaryTreeView {
+public:
+    BinaryTreeView() = default;
+
+    /// Checks header and returns root node.
+    static BinaryTreeView root(std::span<const uint8_t> buffer) noexcept(false);
+
+    [[nodiscard]] bool isValid() const noexcept { return m_data != nullptr; }
+
+    [[nodiscard]] bool isNull() const noexcept(false);
+    [[nodiscard]] bool isScalar() const noexcept(false);
+    [[nodiscard]] bool isList() const noexcept(false);
+    [[nodiscard]] bool isMap() const noexcept(false);
+
+    // number of elements in list or map, 0 for scalars.
+    size_t size() const noexcept(false);
+
+    bool           contains(std::string_view key) const noexcept(false) { return find(key).isValid(); }
+    BinaryTreeView find(std::string_view key) const noexcept(false);
+
+    // Will throw if no such key/index exists or value has another type.
+    BinaryTreeView operator[](std::string_view key) const noexcept(false);
+    BinaryTreeView operator[](size_t index) const noexcept(false);
+
+    // key of this value, if view is a map child obtained by index or iteration. Empty otherwise.
+    std::string_view key() const noexcept(false);
+
+    // convert scalar value. Will throw for null, list or map.
+    // With borrowString string scalar refers to the buffer instead of copying it.
+    PropertyTreeScalar getScalar(bool borrowString = false) const noexcept(false);
+
+    // materialize value into PropertyTree (deep conversion).
+    PropertyTree toPropertyTree(bool borrowStrings = false) const noexcept(false);
+
+    class Iterator;
+
+    // iterate children of list or map. For map children key() returns member name.
+    Iterator begin() const noexcept;
+    Iterator end() const noexcept(false);
+
+private:
+    BinaryTreeView(const uint8_t* data, size_t size, uint32_t offset, uint32_t keyOffset)
+        : m_data(data)
+        , m_size(size)
+        , m_offset(offset)
+        , m_keyOffset(keyOffset)
+    {}
+
+    uint8_t        tag() const noexcept(false);
+    BinaryTreeView child(size_t index) const noexcept(false);
+
+    static constexpr uint32_t s_noKey = UINT32_MAX;
+
+    const uint8_t* m_data      = nullptr;
+    size_t         m_size      = 0;
+    uint32_t       m_offset    = 0;
+    uint32_t       m_keyOffset = s_noKey;
+};
+
+class MERNELPLATFORM_EXPORT BinaryTreeView::Iterator {
+public:
+    BinaryTreeView operator*() const noexcept(false) { return m_parent.child(m_index); }
+    Iterator&      operator++() noexcept
+    {
+        ++m_index;
+        return *this;
+    }
+    bool operator==(const Iterator& rh) const noexcept { return m_index == rh.m_index; }
+
+private:
+    friend class BinaryTreeView;
+    Iterator(const BinaryTreeView& parent, size_t index)
+        : m_parent(parent)
+        , m_index(index)
+    {}
+
+    BinaryTreeView m_parent;
+    size_t         m_index = 0;
+};
+
+inline BinaryTreeView::Iterator BinaryTreeView::begin() const noexcept
+{
+    return Iterator(*this, 0);
+}
+inline BinaryTreeView::Iterator BinaryTreeView::end() const noexcept(false)
+{
+    return Iterator(*this, size());
+}
+
+}
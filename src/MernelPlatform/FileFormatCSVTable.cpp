@@ -6,18 +6,23 @@
 
 #include "FileFormatCSVTable.hpp"
 
+#include "NumberFormat.hpp"
 #include "StringUtils.hpp"
 
 namespace Mernel {
 
 int CSVTableCell::toInt() const
 {
-    return std::atoi(str.c_str());
+    // atoi semantics: leading number is used, 0 if there is none.
+    int value = 0;
+    parseNumber(str, value, true);
+    return value;
 }
 
 void CSVTableCell::setInt(int value)
 {
-    str = std::to_string(value);
+    str.clear();
+    appendNumber(str, value);
 }
 
 std::string CSVTableCell::toLower() const
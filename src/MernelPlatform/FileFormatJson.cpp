@@ -6,39 +6,252 @@
 #include "FileFormatJson.hpp"
 
 #include "Logger.hpp"
+#include "NumberFormat.hpp"
 #include "Profiler.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <iterator>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <unordered_map>
 
 #include <rapidjson/document.h>
 #include <rapidjson/writer.h>
 #include <rapidjson/filestream.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MERNEL_JSON_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MERNEL_JSON_NEON
+#endif
+
 namespace Mernel {
 
 namespace {
 
+/// Input stream for rapidjson::Reader over explicit [begin, end) range. Peek() returns '\0' at the end.
+/// Terminated stream requires readable '\0' at end (std::string has one), so reads are not checked against end at all:
+/// rapidjson stops every token on '\0', and whitespace runs are bounded in skipWhitespace(). Otherwise every read is checked.
+/// For in-situ parsing decoded strings are written back into the same memory (Put* methods).
+template<bool Terminated>
+class JsonStreamIn {
+public:
+    using Ch = char;
+
+    JsonStreamIn(char* begin, char* end)
+        : m_src(begin)
+        , m_begin(begin)
+        , m_end(end)
+    {
+        assert(!Terminated || *end == '\0');
+    }
+
+    char Peek() const
+    {
+        if constexpr (Terminated)
+            return *m_src;
+        else
+            return m_src != m_end ? *m_src : '\0';
+    }
+    char Take()
+    {
+        if constexpr (Terminated)
+            return *m_src++;
+        else
+            return m_src != m_end ? *m_src++ : '\0';
+    }
+    size_t Tell() const { return m_src - m_begin; }
+
+    char*  PutBegin() { return m_dst = m_src; }
+    void   Put(char c) { *m_dst++ = c; }
+    size_t PutEnd(char* begin) { return m_dst - begin; }
+
+    void skipWhitespace()
+    {
+        // 16 bytes at once while whole block is inside the buffer, then byte by byte.
+#if defined(MERNEL_JSON_SSE2)
+        const __m128i space = _mm_set1_epi8(' '), lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r'), tab = _mm_set1_epi8('\t');
+        while (m_end - m_src >= 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_src));
+            __m128i       ws    = _mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, lf));
+            ws                  = _mm_or_si128(ws, _mm_or_si128(_mm_cmpeq_epi8(block, cr), _mm_cmpeq_epi8(block, tab)));
+            const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xFFFFu;
+            if (mask) {
+                m_src += std::countr_zero(mask);
+                return;
+            }
+            m_src += 16;
+        }
+#elif defined(MERNEL_JSON_NEON)
+        const uint8x16_t space = vdupq_n_u8(' '), lf = vdupq_n_u8('\n'), cr = vdupq_n_u8('\r'), tab = vdupq_n_u8('\t');
+        while (m_end - m_src >= 16) {
+            const uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(m_src));
+            uint8x16_t       ws    = vorrq_u8(vceqq_u8(block, space), vceqq_u8(block, lf));
+            ws                     = vorrq_u8(ws, vorrq_u8(vceqq_u8(block, cr), vceqq_u8(block, tab)));
+            if (vminvq_u8(ws) != 0xFF)
+                break;
+            m_src += 16;
+        }
+#endif
+        while ((Terminated || m_src != m_end) && (*m_src == ' ' || *m_src == '\n' || *m_src == '\r' || *m_src == '\t'))
+            ++m_src;
+    }
+
+private:
+    char*       m_src;
+    char*       m_dst = nullptr;
+    char*       m_begin;
+    char*       m_end;
+};
+
+// found by rapidjson::GenericReader through ADL; preferred over generic template.
+template<bool Terminated>
+[[maybe_unused]] inline void SkipWhitespace(JsonStreamIn<Terminated>& stream)
+{
+    stream.skipWhitespace();
+}
+
+/// Output stream for rapidjson::Writer. Characters are collected in a fixed chunk and flushed to the sink in blocks,
+/// so per-character cost is one pointer comparison instead of string growth check.
 class JsonStreamOut {
 public:
-    JsonStreamOut(std::string& output)
-        : m_output(output)
+    explicit JsonStreamOut(std::string& output)
+        : m_string(&output)
+    {}
+    explicit JsonStreamOut(std::ostream& output)
+        : m_stream(&output)
     {}
 
     char   Peek() const { return 0; }
     char   Take() { return 0; }
-    size_t Tell() const { return 0; }
+    size_t Tell() const { return m_flushed + (m_pos - m_chunk); }
 
-    void Put(char c) { m_output += c; }
+    void Put(char c)
+    {
+        if (m_pos == m_end)
+            Flush();
+        *m_pos++ = c;
+    }
+
+    // PutEnd() returns count of characters written since PutBegin(); returned pointer is valid until the next flush.
+    char* PutBegin()
+    {
+        m_putBegin = Tell();
+        return m_pos;
+    }
+    size_t PutEnd(char*) { return Tell() - m_putBegin; }
 
-    char*  PutBegin() { return nullptr; }
-    size_t PutEnd(char*) { return 0; }
+    void Flush()
+    {
+        const size_t size = m_pos - m_chunk;
+        if (m_string)
+            m_string->append(m_chunk, size);
+        else
+            m_stream->write(m_chunk, size);
+        m_flushed += size;
+        m_pos = m_chunk;
+    }
 
 private:
-    std::string& m_output;
+    static constexpr size_t s_chunkSize = 16 * 1024;
+
+    std::string*  m_string = nullptr;
+    std::ostream* m_stream = nullptr;
+    char          m_chunk[s_chunkSize];
+    char*         m_pos      = m_chunk;
+    char* const   m_end      = m_chunk + s_chunkSize;
+    size_t        m_flushed  = 0;
+    size_t        m_putBegin = 0;
+};
+
+/// rapidjson::Writer with doubles in shortest round-trip form (see NumberFormat.hpp) instead of "%.17g".
+class JsonWriter : public rapidjson::Writer<JsonStreamOut> {
+public:
+    using Writer::Writer;
+
+    JsonWriter& Double(double value)
+    {
+        Prefix(rapidjson::kNumberType);
+        char        buffer[s_numberBufferSize + 2];
+        const char* end = formatDoubleWithPoint(buffer, value);
+        for (const char* it = buffer; it != end; ++it)
+            stream_.Put(*it);
+        return *this;
+    }
 };
 
-void jsonToPropery(PropertyTree& data, rapidjson::Value& input)
+/// Upper estimate of compact JSON size, to reserve output buffer at once.
+size_t estimateJsonSize(const PropertyTree& data)
+{
+    if (data.isList()) {
+        size_t result = 2;
+        for (const PropertyTree& child : data.getList())
+            result += estimateJsonSize(child) + 1;
+        return result;
+    }
+    if (data.isMap()) {
+        size_t result = 2;
+        for (const auto& [key, child] : data.getMap())
+            result += key.size() + 4 + estimateJsonSize(child);
+        return result;
+    }
+    if (data.isScalar()) {
+        const auto& scalar = data.getScalar();
+        if (scalar.isString())
+            return scalar.toStringView().size() + 2;
+        if (scalar.isDouble())
+            return 24;
+        if (scalar.isInt())
+            return 20;
+        return 5;
+    }
+    return 4;
+}
+
+// number of chunks root children are split into for parallel conversion; more than cores for load balancing.
+constexpr size_t s_parallelTaskCount = 64;
+
+class ReadContext {
+public:
+    struct Params {
+        bool m_internKeys    = false;
+        bool m_borrowStrings = false;
+    };
+
+    explicit ReadContext(const Params& params)
+        : m_internKeys(params.m_internKeys)
+        , m_borrowStrings(params.m_borrowStrings)
+    {}
+
+    PropertyTreeKey makeKey(std::string_view str)
+    {
+        if (!m_internKeys)
+            return PropertyTreeKey(str);
+
+        // local cache avoids locking global atom table for every repeated key in the document.
+        if (auto it = m_keyCache.find(str); it != m_keyCache.cend())
+            return it->second;
+        PropertyTreeKey key = PropertyTreeKey::intern(str);
+        m_keyCache.emplace(key.view(), key);
+        return key;
+    }
+
+    PropertyTreeScalar makeString(std::string_view str)
+    {
+        return m_borrowStrings ? PropertyTreeScalar::borrowed(str) : PropertyTreeScalar(str);
+    }
+
+private:
+    const bool                                            m_internKeys;
+    const bool                                            m_borrowStrings;
+    std::unordered_map<std::string_view, PropertyTreeKey> m_keyCache;
+};
+
+void jsonToPropery(PropertyTree& data, rapidjson::Value& input, ReadContext& context)
 {
     switch (input.GetType()) {
         case rapidjson::kNullType:
@@ -55,27 +268,27 @@ void jsonToPropery(PropertyTree& data, rapidjson::Value& input)
         } break;
         case rapidjson::kObjectType:
         {
-            data.convertToMap();
-            auto& m = data.getMap();
+            PropertyTreeMap m;
+            m.reserve(std::distance(input.MemberBegin(), input.MemberEnd()));
             for (auto keyIt = input.MemberBegin(); keyIt != input.MemberEnd(); ++keyIt) {
-                std::string key(keyIt->name.GetString(), keyIt->name.GetStringLength());
-                jsonToPropery(m[key], keyIt->value);
+                const std::string_view key(keyIt->name.GetString(), keyIt->name.GetStringLength());
+                jsonToPropery(m.appendUnsorted(context.makeKey(key)), keyIt->value, context);
             }
+            m.sortAppended();
+            data = PropertyTree(std::move(m));
         } break;
         case rapidjson::kArrayType:
         {
-            data.convertToList();
-            auto& l = data.getList();
-            l.resize(std::distance(input.Begin(), input.End()));
-            size_t index = 0;
+            PropertyTreeList l(std::distance(input.Begin(), input.End()));
+            size_t           index = 0;
             for (auto nodeIt = input.Begin(); nodeIt != input.End(); ++nodeIt) {
-                jsonToPropery(l[index++], *nodeIt);
+                jsonToPropery(l[index++], *nodeIt, context);
             }
+            data = PropertyTree(std::move(l));
         } break;
         case rapidjson::kStringType:
         {
-            std::string inputString(input.GetString(), input.GetStringLength());
-            data = PropertyTreeScalar(std::move(inputString));
+            data = context.makeString(std::string_view(input.GetString(), input.GetStringLength()));
         } break;
         case rapidjson::kNumberType:
         {
@@ -93,51 +306,221 @@ void jsonToPropery(PropertyTree& data, rapidjson::Value& input)
     }
 }
 
-void propertyToJson(const PropertyTree& data, rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator)
+/// Handler for rapidjson::Reader, builds PropertyTree directly from parse events without intermediate rapidjson::Document.
+/// Like Document, it keeps values of unfinished containers on a stack and moves them into container of exact size when it ends;
+/// stacks are reused, so each container costs one allocation. Map members are appended in document order and sorted once.
+class PropertyTreeHandler {
+public:
+    using Ch = char;
+
+    explicit PropertyTreeHandler(ReadContext& context)
+        : m_context(context)
+    {}
+
+    void Null() { pushValue({}); }
+    void Bool(bool value) { pushValue(PropertyTreeScalar(value)); }
+    void Int(int value) { pushValue(PropertyTreeScalar(std::int64_t(value))); }
+    void Uint(unsigned value) { pushValue(PropertyTreeScalar(std::int64_t(value))); }
+    void Int64(int64_t value) { pushValue(PropertyTreeScalar(std::int64_t(value))); }
+    void Uint64(uint64_t value) { pushValue(PropertyTreeScalar(std::int64_t(value))); }
+    void Double(double value) { pushValue(PropertyTreeScalar(value)); }
+
+    void String(const char* str, rapidjson::SizeType length, bool)
+    {
+        const std::string_view view(str, length);
+        // reader does not distinguish member names, they are strings in the key position of an object.
+        if (!m_frames.empty() && m_frames.back() == Frame::Key) {
+            m_frames.back() = Frame::Value;
+            m_keys.push_back(m_context.makeKey(view));
+            return;
+        }
+        pushValue(m_context.makeString(view));
+    }
+
+    void StartObject() { m_frames.push_back(Frame::Key); }
+    void EndObject(rapidjson::SizeType memberCount)
+    {
+        const size_t firstValue = m_values.size() - memberCount;
+        const size_t firstKey   = m_keys.size() - memberCount;
+
+        PropertyTreeMap map;
+        map.reserve(memberCount);
+        for (size_t i = 0; i < memberCount; ++i)
+            map.appendUnsorted(std::move(m_keys[firstKey + i])) = std::move(m_values[firstValue + i]);
+        map.sortAppended();
+
+        m_keys.resize(firstKey);
+        m_values.resize(firstValue);
+        m_frames.pop_back();
+        pushValue(PropertyTree(std::move(map)));
+    }
+
+    void StartArray() { m_frames.push_back(Frame::List); }
+    void EndArray(rapidjson::SizeType elementCount)
+    {
+        const size_t firstValue = m_values.size() - elementCount;
+
+        PropertyTreeList list;
+        list.reserve(elementCount);
+        std::move(m_values.begin() + firstValue, m_values.end(), std::back_inserter(list));
+
+        m_values.resize(firstValue);
+        m_frames.pop_back();
+        pushValue(PropertyTree(std::move(list)));
+    }
+
+    /// Valid after successful parse.
+    PropertyTree takeResult() { return std::move(m_values.back()); }
+
+private:
+    enum class Frame : uint8_t
+    {
+        List,
+        Key,
+        Value,
+    };
+
+    void pushValue(PropertyTree&& value)
+    {
+        m_values.push_back(std::move(value));
+        if (!m_frames.empty() && m_frames.back() == Frame::Value)
+            m_frames.back() = Frame::Key;
+    }
+
+    ReadContext&                 m_context;
+    std::vector<PropertyTree>    m_values;
+    std::vector<PropertyTreeKey> m_keys;
+    std::vector<Frame>           m_frames;
+};
+
+// converts children of root container in separate tasks. Slots are created upfront, so tasks do not touch the containers;
+// each task has its own ReadContext, as key cache is not thread-safe.
+void jsonToProperyParallel(PropertyTree& data, rapidjson::Value& input, const ReadContext::Params& contextParams, const std::function<void(std::vector<std::function<void()>>)>& runner)
 {
-    if (data.isNull()) {
-    } else if (data.isList()) {
-        json.SetArray();
-        for (const PropertyTree& child : data.getList()) {
-            rapidjson::Value tempValue;
-            propertyToJson(child, tempValue, allocator);
-            json.PushBack(tempValue, allocator);
+    std::vector<std::pair<PropertyTree*, rapidjson::Value*>> items;
+    PropertyTreeMap                                          m;
+    PropertyTreeList                                         l;
+    if (input.IsObject()) {
+        ReadContext context(contextParams);
+        // reserved upfront, so slot addresses stay valid with either map backend.
+        m.reserve(input.MemberEnd() - input.MemberBegin());
+        items.reserve(input.MemberEnd() - input.MemberBegin());
+        for (auto keyIt = input.MemberBegin(); keyIt != input.MemberEnd(); ++keyIt) {
+            const std::string_view key(keyIt->name.GetString(), keyIt->name.GetStringLength());
+            const size_t           size = m.size();
+            PropertyTree*          slot = &m.appendUnsorted(context.makeKey(key));
+            if (m.size() != size) {
+                items.emplace_back(slot, &keyIt->value);
+                continue;
+            }
+            // duplicate key in a node map shares the slot: the last value wins, as in sequential parse.
+            std::find_if(items.begin(), items.end(), [slot](const auto& item) { return item.first == slot; })->second = &keyIt->value;
         }
+    } else {
+        l.resize(input.Size());
+        items.reserve(l.size());
+        for (rapidjson::SizeType i = 0; i < input.Size(); ++i)
+            items.emplace_back(&l[i], &input[i]);
+    }
+
+    const size_t                       taskCount = std::min(items.size(), s_parallelTaskCount);
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(taskCount);
+    for (size_t task = 0; task < taskCount; ++task) {
+        const size_t begin = items.size() * task / taskCount;
+        const size_t end   = items.size() * (task + 1) / taskCount;
+        tasks.push_back([&items, &contextParams, begin, end] {
+            ReadContext context(contextParams);
+            for (size_t i = begin; i < end; ++i)
+                jsonToPropery(*items[i].first, *items[i].second, context);
+        });
+    }
+    runner(std::move(tasks));
+
+    if (input.IsObject()) {
+        m.sortAppended();
+        data = PropertyTree(std::move(m));
+    } else {
+        data = PropertyTree(std::move(l));
+    }
+}
+
+/// Feeds PropertyTree to rapidjson::Writer directly; keys and strings are passed by pointer, nothing is copied.
+template<class Writer>
+void propertyToJson(const PropertyTree& data, Writer& writer)
+{
+    if (data.isList()) {
+        writer.StartArray();
+        for (const PropertyTree& child : data.getList())
+            propertyToJson(child, writer);
+        writer.EndArray();
     } else if (data.isMap()) {
-        json.SetObject();
-        for (const auto& p : data.getMap()) {
-            const PropertyTree& child = p.second;
-            rapidjson::Value    tempValue;
-            propertyToJson(child, tempValue, allocator);
-            json.AddMember(p.first.c_str(), allocator, tempValue, allocator);
+        writer.StartObject();
+        for (const auto& [key, child] : data.getMap()) {
+            writer.String(key.c_str(), static_cast<rapidjson::SizeType>(key.size()));
+            propertyToJson(child, writer);
         }
-    } else if (data.isScalar()) {
+        writer.EndObject();
+    } else if (data.isScalar() && !data.getScalar().isNull()) {
         const auto& scalar = data.getScalar();
         if (scalar.isBool())
-            json.SetBool(scalar.toBool());
+            writer.Bool(scalar.toBool());
         if (scalar.isInt())
-            json.SetInt64(scalar.toInt());
+            writer.Int64(scalar.toInt());
         if (scalar.isDouble())
-            json.SetDouble(scalar.toDouble());
+            writer.Double(scalar.toDouble());
         if (scalar.isString()) {
-            const auto s = scalar.toString();
-            json.SetString(s.data(), static_cast<rapidjson::SizeType>(s.size()), allocator);
+            const auto str = scalar.toStringView();
+            writer.String(str.data(), static_cast<rapidjson::SizeType>(str.size()));
         }
+    } else {
+        writer.Null();
     }
 }
 
 }
 
-bool readJsonFromBufferNoexcept(const std::string& buffer, PropertyTree& data) noexcept(true)
+namespace {
+std::span<char> skipBom(std::span<char> buffer)
+{
+    if (std::string_view(buffer.data(), buffer.size()).starts_with(std::string_view("\xef\xbb\xbf", 3)))
+        return buffer.subspan(3);
+    return buffer;
+}
+
+template<bool Terminated>
+bool parseJson(std::span<char> buffer, bool insitu, PropertyTree& data, const JsonReadParams& params, bool borrowStrings)
 {
+    const ReadContext::Params contextParams{ .m_internKeys = params.m_internKeys, .m_borrowStrings = borrowStrings };
+    JsonStreamIn<Terminated>  stream(buffer.data(), buffer.data() + buffer.size());
+
+    if (!params.m_parallelRunner) {
+        // tree is built straight from reader events; strings are copied once, from the stream (or not at all when borrowed).
+        ReadContext         context(contextParams);
+        PropertyTreeHandler handler(context);
+        rapidjson::Reader   reader;
+        if (insitu)
+            reader.Parse<rapidjson::kParseInsituFlag>(stream, handler);
+        else
+            reader.Parse<0>(stream, handler);
+
+        if (reader.HasParseError()) {
+            Logger(Logger::Err) << reader.GetParseError() << " (" << reader.GetErrorOffset() << ")";
+            return false;
+        }
+        data = handler.takeResult();
+        return true;
+    }
+
+    // parallel conversion needs whole document to split root children between tasks.
     rapidjson::Document input;
-    const char*         dataPtr = buffer.data();
-    if (buffer.starts_with(std::string_view("\xef\xbb\xbf", 3)))
-        dataPtr += 3;
+    if (insitu)
+        input.ParseStream<rapidjson::kParseInsituFlag>(stream);
+    else
+        input.ParseStream<0>(stream);
 
-    auto& res = input.Parse<0>(dataPtr);
-    if (res.HasParseError()) {
-        Logger(Logger::Err) << res.GetParseError() << " (" << res.GetErrorOffset() << ")";
+    if (input.HasParseError()) {
+        Logger(Logger::Err) << input.GetParseError() << " (" << input.GetErrorOffset() << ")";
         return false;
     }
 
@@ -145,36 +528,88 @@ bool readJsonFromBufferNoexcept(const std::string& buffer, PropertyTree& data) n
         return false;
 
     data = PropertyTree{};
-    jsonToPropery(data, input);
-
+    const size_t rootSize = input.IsObject() ? input.MemberEnd() - input.MemberBegin() : input.Size();
+    if (rootSize >= params.m_parallelMinChildren) {
+        jsonToProperyParallel(data, input, contextParams, params.m_parallelRunner);
+        return true;
+    }
+    ReadContext context(contextParams);
+    jsonToPropery(data, input, context);
     return true;
 }
+}
+
+bool readJsonFromBufferNoexcept(const std::string& buffer, PropertyTree& data, const JsonReadParams& params) noexcept(true)
+{
+    // stream is not written to without in-situ flag.
+    std::span<char> source = skipBom(std::span<char>(const_cast<char*>(buffer.data()), buffer.size()));
+
+    // in-situ parsing leaves unescaped zero-terminated strings inside the buffer, so copy in arena may be referenced by the tree.
+    // both buffers have '\0' after the end, so reads need no bounds check.
+    PropertyTreeArena* arena = PropertyTreeArena::current();
+    if (params.m_borrowStrings && arena) {
+        char* insituBuffer = static_cast<char*>(arena->allocate(source.size() + 1, 1));
+        std::memcpy(insituBuffer, source.data(), source.size());
+        insituBuffer[source.size()] = '\0';
+        return parseJson<true>({ insituBuffer, source.size() }, true, data, params, true);
+    }
+    return parseJson<true>(source, false, data, params, false);
+}
+
+bool readJsonFromMutableBufferNoexcept(std::span<char> buffer, PropertyTree& data, const JsonReadParams& params) noexcept(true)
+{
+    // memory past the span may be not readable.
+    return parseJson<false>(skipBom(buffer), true, data, params, params.m_borrowStrings);
+}
 
 bool writeJsonToBufferNoexcept(std::string& buffer, const PropertyTree& data, bool pretty) noexcept(true)
 {
     if (pretty) {
-        std::ostringstream os;
-        PropertyTree::printReadableJson(os, data);
-        buffer = os.str();
+        buffer.clear();
+        PropertyTree::printReadableJson(buffer, data);
         return true;
     }
     if (data.isNull()) {
         return false;
     }
-    rapidjson::Document json;
-    propertyToJson(data, json, json.GetAllocator());
-
+    buffer.reserve(buffer.size() + estimateJsonSize(data));
     JsonStreamOut                    outStream(buffer);
-    rapidjson::Writer<JsonStreamOut> writer(outStream);
-    json.Accept(writer);
+    JsonWriter                       writer(outStream);
+    propertyToJson(data, writer);
+    outStream.Flush();
 
     return true;
 }
 
-PropertyTree readJsonFromBuffer(const std::string& buffer) noexcept(false)
+bool writeJsonToStreamNoexcept(std::ostream& stream, const PropertyTree& data, bool pretty) noexcept(true)
+{
+    if (pretty) {
+        PropertyTree::printReadableJson(stream, data);
+        return stream.good();
+    }
+    if (data.isNull()) {
+        return false;
+    }
+    JsonStreamOut                    outStream(stream);
+    JsonWriter                       writer(outStream);
+    propertyToJson(data, writer);
+    outStream.Flush();
+
+    return stream.good();
+}
+
+PropertyTree readJsonFromBuffer(const std::string& buffer, const JsonReadParams& params) noexcept(false)
+{
+    PropertyTree result;
+    if (!readJsonFromBufferNoexcept(buffer, result, params))
+        throw std::runtime_error("Failed to read JSON");
+    return result;
+}
+
+PropertyTree readJsonFromMutableBuffer(std::span<char> buffer, const JsonReadParams& params) noexcept(false)
 {
     PropertyTree result;
-    if (!readJsonFromBufferNoexcept(buffer, result))
+    if (!readJsonFromMutableBufferNoexcept(buffer, result, params))
         throw std::runtime_error("Failed to read JSON");
     return result;
 }
@@ -187,4 +622,10 @@ std::string writeJsonToBuffer(const PropertyTree& data, bool pretty) noexcept(fa
     return buffer;
 }
 
+void writeJsonToStream(std::ostream& stream, const PropertyTree& data, bool pretty) noexcept(false)
+{
+    if (!writeJsonToStreamNoexcept(stream, data, pretty))
+        throw std::runtime_error("Failed to write JSON");
+}
+
 }
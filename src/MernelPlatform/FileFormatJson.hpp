@@ -9,14 +9,43 @@
 
 #include "MernelPlatformExport.hpp"
 
+#include <functional>
+#include <span>
+#include <vector>
+
 namespace Mernel {
 
 /// @todo: rewrite noexcept version as wrappers over throwing.
 
-MERNELPLATFORM_EXPORT bool readJsonFromBufferNoexcept(const std::string& buffer, PropertyTree& data) noexcept(true);
+struct JsonReadParams {
+    /// Make object keys atoms (see PropertyTreeKey::intern). Useful for large documents with repeating field names,
+    /// as keys share memory and lookup by atom is cheaper. Do not enable for documents with arbitrary keys.
+    bool m_internKeys = false;
+    /// Keep string values in a copy of the buffer placed in current PropertyTreeArena instead of separate allocations
+    /// (see PropertyTreeScalar::borrowed). Ignored if there is no arena.
+    bool m_borrowStrings = false;
+
+    /// Runs independent tasks, possibly concurrently, and returns when all of them are finished
+    /// (e.g. with execTasks() from MernelExecution). When set, children of the root list or map are converted
+    /// to PropertyTree in parallel, result is the same as for sequential conversion.
+    /// Note that subtrees built on worker threads do not use PropertyTreeArena of the calling thread.
+    std::function<void(std::vector<std::function<void()>> tasks)> m_parallelRunner;
+    /// Root with fewer children is converted sequentially.
+    size_t m_parallelMinChildren = 256;
+};
+
+MERNELPLATFORM_EXPORT bool readJsonFromBufferNoexcept(const std::string& buffer, PropertyTree& data, const JsonReadParams& params = {}) noexcept(true);
+/// Parses JSON in place: buffer content is destroyed (strings are unescaped inside it), but nothing is copied.
+/// Buffer size is explicit, terminating zero is not needed. With m_borrowStrings string values refer directly into the buffer,
+/// so it must outlive the tree (arena is not required).
+MERNELPLATFORM_EXPORT bool readJsonFromMutableBufferNoexcept(std::span<char> buffer, PropertyTree& data, const JsonReadParams& params = {}) noexcept(true);
 MERNELPLATFORM_EXPORT bool writeJsonToBufferNoexcept(std::string& buffer, const PropertyTree& data, bool pretty = false) noexcept(true);
+/// Writes JSON text to the stream in blocks, without keeping whole text in memory. Useful for large exports directly into file.
+MERNELPLATFORM_EXPORT bool writeJsonToStreamNoexcept(std::ostream& stream, const PropertyTree& data, bool pretty = false) noexcept(true);
 
-MERNELPLATFORM_EXPORT PropertyTree readJsonFromBuffer(const std::string& buffer) noexcept(false);
+MERNELPLATFORM_EXPORT PropertyTree readJsonFromBuffer(const std::string& buffer, const JsonReadParams& params = {}) noexcept(false);
+MERNELPLATFORM_EXPORT PropertyTree readJsonFromMutableBuffer(std::span<char> buffer, const JsonReadParams& params = {}) noexcept(false);
 MERNELPLATFORM_EXPORT std::string writeJsonToBuffer(const PropertyTree& data, bool pretty = false) noexcept(false);
+MERNELPLATFORM_EXPORT void        writeJsonToStream(std::ostream& stream, const PropertyTree& data, bool pretty = false) noexcept(false);
 
 }
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "FileFormatJsonEmitter.hpp"
+
+#include "NumberFormat.hpp"
+
+namespace Mernel {
+
+namespace {
+// same escaping rules as rapidjson::Writer.
+constexpr char s_hexDigits[] = "0123456789ABCDEF";
+
+constexpr char escapeChar(uint8_t c)
+{
+    switch (c) {
+        case '\b':
+            return 'b';
+        case '\t':
+            return 't';
+        case '\n':
+            return 'n';
+        case '\f':
+            return 'f';
+        case '\r':
+            return 'r';
+        case '"':
+            return '"';
+        case '\\':
+            return '\\';
+        default:
+            return c < 0x20 ? 'u' : 0;
+    }
+}
+
+}
+
+void JsonEmitter::prefix()
+{
+    if (m_afterKey) {
+        m_afterKey = false;
+        return;
+    }
+    if (m_hasElements.empty())
+        return;
+    if (m_hasElements.back())
+        m_output += ',';
+    m_hasElements.back() = true;
+}
+
+void JsonEmitter::beginMap()
+{
+    prefix();
+    m_output += '{';
+    m_hasElements.push_back(false);
+}
+
+void JsonEmitter::endMap()
+{
+    m_hasElements.pop_back();
+    m_output += '}';
+}
+
+void JsonEmitter::beginList()
+{
+    prefix();
+    m_output += '[';
+    m_hasElements.push_back(false);
+}
+
+void JsonEmitter::endList()
+{
+    m_hasElements.pop_back();
+    m_output += ']';
+}
+
+void JsonEmitter::key(std::string_view key)
+{
+    prefix();
+    appendEscaped(key);
+    m_output += ':';
+    m_afterKey = true;
+}
+
+void JsonEmitter::writeNull()
+{
+    prefix();
+    m_output += "null";
+}
+
+void JsonEmitter::writeBool(bool value)
+{
+    prefix();
+    m_output += value ? "true" : "false";
+}
+
+void JsonEmitter::writeInt(int64_t value)
+{
+    prefix();
+    appendNumber(m_output, value);
+}
+
+void JsonEmitter::writeDouble(double value)
+{
+    prefix();
+    // shortest round-trip form; ".0" keeps integral value recognizable as double on read.
+    appendDoubleWithPoint(m_output, value);
+}
+
+void JsonEmitter::writeString(std::string_view value)
+{
+    prefix();
+    appendEscaped(value);
+}
+
+void JsonEmitter::appendEscaped(std::string_view value)
+{
+    m_output.reserve(m_output.size() + value.size() + 2);
+    m_output += '"';
+    size_t runStart = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        const uint8_t c      = static_cast<uint8_t>(value[i]);
+        const char    escape = escapeChar(c);
+        if (!escape)
+            continue;
+        m_output.append(value.data() + runStart, i - runStart);
+        runStart = i + 1;
+        m_output += '\\';
+        m_output += escape;
+        if (escape == 'u') {
+            m_output += "00";
+            m_output += s_hexDigits[c >> 4];
+            m_output += s_hexDigits[c & 0xF];
+        }
+    }
+    m_output.append(value.data() + runStart, value.size() - runStart);
+    m_output += '"';
+}
+
+void JsonEmitter::writeScalar(const PropertyTreeScalar& scalar)
+{
+    if (scalar.isBool())
+        writeBool(scalar.toBool());
+    else if (scalar.isInt())
+        writeInt(scalar.toInt());
+    else if (scalar.isDouble())
+        writeDouble(scalar.toDouble());
+    else if (scalar.isString())
+        writeString(scalar.toStringView());
+    else
+        writeNull();
+}
+
+void JsonEmitter::writeTree(const PropertyTree& tree)
+{
+    if (tree.isList()) {
+        beginList();
+        for (const PropertyTree& child : tree.getList())
+            writeTree(child);
+        endList();
+    } else if (tree.isMap()) {
+        beginMap();
+        for (const auto& [childKey, child] : tree.getMap()) {
+            key(childKey.view());
+            writeTree(child);
+        }
+        endMap();
+    } else if (tree.isScalar()) {
+        writeScalar(tree.getScalar());
+    } else {
+        writeNull();
+    }
+}
+
+}
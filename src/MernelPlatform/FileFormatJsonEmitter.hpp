@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "PropertyTree.hpp"
+
+#include "MernelPlatformExport.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mernel {
+
+/**
+ * @brief Writes compact JSON text directly into a string, without intermediate document.
+ *
+ * Separators are inserted automatically, caller only has to keep begin/end calls balanced and call key() before every map value.
+ * Output is the same as writeJsonToBuffer() produces for compact mode.
+ */
+class MERNELPLATFORM_EXPORT JsonEmitter {
+public:
+    explicit JsonEmitter(std::string& output) noexcept
+        : m_output(output)
+    {}
+
+    void beginMap();
+    void endMap();
+    void beginList();
+    void endList();
+
+    void key(std::string_view key);
+
+    void writeNull();
+    void writeBool(bool value);
+    void writeInt(int64_t value);
+    void writeDouble(double value);
+    void writeString(std::string_view value);
+
+    void writeScalar(const PropertyTreeScalar& scalar);
+    void writeTree(const PropertyTree& tree);
+
+private:
+    void prefix();
+    void appendEscaped(std::string_view value);
+
+    std::string&      m_output;
+    std::vector<bool> m_hasElements;
+    bool              m_afterKey = false;
+};
+
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "FileFormatJsonLines.hpp"
+
+#include "PropertyTreeArena.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+
+namespace Mernel {
+
+namespace {
+const size_t s_parallelTaskCount = 64;
+
+bool isBlank(std::span<const char> line)
+{
+    return std::string_view(line.data(), line.size()).find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+}
+
+JsonLinesReader::JsonLinesReader(std::istream& stream, JsonReadParams params, size_t chunkSize)
+    : m_stream(stream)
+    , m_params(std::move(params))
+{
+    m_buffer.resize(std::max(chunkSize, size_t(1)));
+}
+
+bool JsonLinesReader::next(PropertyTree& record) noexcept(false)
+{
+    std::span<char> line;
+    if (!nextLine(line, true))
+        return false;
+
+    PropertyTreeArena* arena = PropertyTreeArena::current();
+    if (m_params.m_borrowStrings && !arena) {
+        JsonReadParams params  = m_params;
+        params.m_borrowStrings = false;
+        parseLine(line, m_lineNumber, record, params);
+        return true;
+    }
+    if (m_params.m_borrowStrings) {
+        // read buffer is reused for the next lines.
+        char* arenaLine = static_cast<char*>(arena->allocate(line.size(), 1));
+        std::memcpy(arenaLine, line.data(), line.size());
+        line = { arenaLine, line.size() };
+    }
+    parseLine(line, m_lineNumber, record, m_params);
+    return true;
+}
+
+size_t JsonLinesReader::nextBatch(std::vector<PropertyTree>& records, size_t maxRecords) noexcept(false)
+{
+    // lines stay valid until buffer is refilled, so only the first line may cause reading.
+    std::vector<std::span<char>> lines;
+    std::vector<size_t>          lineNumbers;
+    std::span<char>              line;
+    while (lines.size() < maxRecords && nextLine(line, lines.empty())) {
+        lines.push_back(line);
+        lineNumbers.push_back(m_lineNumber);
+    }
+
+    JsonReadParams params = m_params;
+    params.m_parallelRunner = nullptr;
+
+    PropertyTreeArena* arena = PropertyTreeArena::current();
+    if (params.m_borrowStrings && arena && !lines.empty()) {
+        // batch lines are adjacent in the buffer, copy them at once.
+        char* const  begin = lines.front().data();
+        const size_t size  = lines.back().data() + lines.back().size() - begin;
+        char*        copy  = static_cast<char*>(arena->allocate(size, 1));
+        std::memcpy(copy, begin, size);
+        for (auto& batchLine : lines)
+            batchLine = { copy + (batchLine.data() - begin), batchLine.size() };
+    } else {
+        params.m_borrowStrings = false;
+    }
+
+    records.resize(lines.size());
+    if (!m_params.m_parallelRunner || lines.size() < 2) {
+        for (size_t i = 0; i < lines.size(); ++i)
+            parseLine(lines[i], lineNumbers[i], records[i], params);
+        return lines.size();
+    }
+
+    const size_t                       taskCount = std::min(s_parallelTaskCount, lines.size());
+    std::vector<std::string>           errors(taskCount);
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(taskCount);
+    for (size_t task = 0; task < taskCount; ++task) {
+        const size_t begin = lines.size() * task / taskCount;
+        const size_t end   = lines.size() * (task + 1) / taskCount;
+        tasks.push_back([this, begin, end, &lines, &lineNumbers, &records, &params, &error = errors[task]] {
+            try {
+                for (size_t i = begin; i < end; ++i)
+                    parseLine(lines[i], lineNumbers[i], records[i], params);
+            }
+            catch (std::exception& ex) {
+                error = ex.what();
+            }
+        });
+    }
+    m_params.m_parallelRunner(std::move(tasks));
+
+    for (const std::string& error : errors) {
+        if (!error.empty())
+            throw std::runtime_error(error);
+    }
+    return lines.size();
+}
+
+bool JsonLinesReader::nextLine(std::span<char>& line, bool allowRead) noexcept(false)
+{
+    while (true) {
+        char* const data = m_buffer.data();
+        if (auto* newline = static_cast<char*>(std::memchr(data + m_searchPos, '\n', m_end - m_searchPos))) {
+            line        = { data + m_begin, static_cast<size_t>(newline - data) - m_begin };
+            m_begin     = newline - data + 1;
+            m_searchPos = m_begin;
+            ++m_lineNumber;
+            if (isBlank(line))
+                continue;
+            return true;
+        }
+        m_searchPos = m_end;
+
+        if (m_eof) {
+            // last line without trailing newline.
+            if (m_begin == m_end)
+                return false;
+            line    = { data + m_begin, m_end - m_begin };
+            m_begin = m_searchPos = m_end;
+            ++m_lineNumber;
+            if (isBlank(line))
+                return false;
+            return true;
+        }
+        if (!allowRead)
+            return false;
+        fillBuffer();
+    }
+}
+
+void JsonLinesReader::fillBuffer() noexcept(false)
+{
+    if (m_begin > 0) {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_searchPos -= m_begin;
+        m_begin = 0;
+    }
+    // line is longer than the buffer.
+    if (m_end == m_buffer.size())
+        m_buffer.resize(m_buffer.size() * 2);
+
+    m_stream.read(m_buffer.data() + m_end, m_buffer.size() - m_end);
+    const size_t count = static_cast<size_t>(m_stream.gcount());
+    if (m_stream.bad())
+        throw std::runtime_error("JSON Lines: failed to read stream");
+    m_end += count;
+    if (!m_stream || count == 0)
+        m_eof = true;
+}
+
+void JsonLinesReader::parseLine(std::span<char> line, size_t lineNumber, PropertyTree& record, const JsonReadParams& params) const noexcept(false)
+{
+    if (!readJsonFromMutableBufferNoexcept(line, record, params))
+        throw std::runtime_error("JSON Lines: failed to parse line " + std::to_string(lineNumber));
+}
+
+JsonLinesWriter::JsonLinesWriter(std::ostream& stream, size_t chunkSize)
+    : m_stream(stream)
+    , m_chunkSize(chunkSize)
+{
+    m_buffer.reserve(m_chunkSize);
+}
+
+JsonLinesWriter::~JsonLinesWriter()
+{
+    if (!m_buffer.empty())
+        m_stream.write(m_buffer.data(), m_buffer.size());
+}
+
+void JsonLinesWriter::write(const PropertyTree& record) noexcept(false)
+{
+    if (!writeJsonToBufferNoexcept(m_buffer, record))
+        throw std::runtime_error("JSON Lines: failed to write record");
+    m_buffer += '\n';
+    if (m_buffer.size() >= m_chunkSize)
+        flush();
+}
+
+void JsonLinesWriter::flush() noexcept(false)
+{
+    m_stream.write(m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+    if (!m_stream)
+        throw std::runtime_error("JSON Lines: failed to write stream");
+}
+
+}
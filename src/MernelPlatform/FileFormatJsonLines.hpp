@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "FileFormatJson.hpp"
+
+#include "MernelPlatformExport.hpp"
+
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Mernel {
+
+/**
+ * @brief Reads newline-delimited JSON (JSON Lines) from a stream, one record at a time.
+ *
+ * Stream is read in chunks, so memory usage is bounded by chunk size and the longest line,
+ * not by the size of the stream (any std::istream works, e.g. file or decompressing stream).
+ * Every non-blank line must be a JSON object or array. Lines are parsed in place inside the read buffer.
+ * With m_borrowStrings strings are copied to the current PropertyTreeArena (buffer is reused), without arena the option is ignored.
+ *
+ * General usage:
+ *
+ * std::ifstream    file(path, std::ios::binary);
+ * JsonLinesReader  reader(file);
+ * PropertyTree     record;
+ * while (reader.next(record))
+ *     Reflection::PropertyTreeReader().jsonToValue(record, event);
+ */
+class MERNELPLATFORM_EXPORT JsonLinesReader {
+public:
+    static constexpr size_t s_defaultChunkSize = 1 << 20;
+
+    explicit JsonLinesReader(std::istream& stream, JsonReadParams params = {}, size_t chunkSize = s_defaultChunkSize);
+
+    /// Returns false at the end of stream. Throws on malformed line or stream error.
+    bool next(PropertyTree& record) noexcept(false);
+
+    /// Reads up to maxRecords records into records (resized to the number read).
+    /// If params have m_parallelRunner, records are decoded in parallel; nested parallel conversion of a single record is not done.
+    /// Batch is limited to lines already present in the read buffer, so it may be shorter than maxRecords; 0 means end of stream.
+    size_t nextBatch(std::vector<PropertyTree>& records, size_t maxRecords) noexcept(false);
+
+    /// Number of the last line read, 1-based (blank lines are counted too).
+    size_t lineNumber() const noexcept { return m_lineNumber; }
+
+private:
+    bool nextLine(std::span<char>& line, bool allowRead) noexcept(false);
+    void fillBuffer() noexcept(false);
+    void parseLine(std::span<char> line, size_t lineNumber, PropertyTree& record, const JsonReadParams& params) const noexcept(false);
+
+    std::istream&     m_stream;
+    JsonReadParams    m_params;
+    std::vector<char> m_buffer;
+    size_t            m_begin      = 0; ///< start of unread data in m_buffer
+    size_t            m_end        = 0; ///< end of data in m_buffer
+    size_t            m_searchPos  = 0; ///< no newline in [m_begin, m_searchPos)
+    size_t            m_lineNumber = 0;
+    bool              m_eof        = false;
+};
+
+/**
+ * @brief Writes PropertyTree records as JSON Lines: compact JSON, one record per line.
+ *
+ * Output is accumulated up to chunk size and written to the stream in blocks. Destructor flushes remaining data.
+ */
+class MERNELPLATFORM_EXPORT JsonLinesWriter {
+public:
+    static constexpr size_t s_defaultChunkSize = 1 << 16;
+
+    explicit JsonLinesWriter(std::ostream& stream, size_t chunkSize = s_defaultChunkSize);
+    ~JsonLinesWriter();
+
+    /// Throws if record is null or stream is in a failed state.
+    void write(const PropertyTree& record) noexcept(false);
+    void flush() noexcept(false);
+
+private:
+    std::ostream& m_stream;
+    std::string   m_buffer;
+    size_t        m_chunkSize;
+};
+
+}
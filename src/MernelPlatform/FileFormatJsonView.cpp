@@ -0,0 +1,682 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "FileFormatJsonView.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Mernel {
+
+namespace {
+constexpr size_t s_linearLookupSize = 16;
+
+[[noreturn]] void throwError(const char* message, size_t offset)
+{
+    throw std::runtime_error("JSON error at offset " + std::to_string(offset) + ": " + message);
+}
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool isValueEnd(char c)
+{
+    return c == ',' || c == ']' || c == '}' || c == 0 || isSpace(c);
+}
+
+// JSON literal or number: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)? - no inf, nan, hex or leading zeros.
+bool isValidToken(std::string_view text)
+{
+    if (text == "null" || text == "true" || text == "false")
+        return true;
+    size_t pos    = 0;
+    auto   digits = [&text, &pos] {
+        const size_t start = pos;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+            ++pos;
+        return pos > start;
+    };
+    auto skip = [&text, &pos](char c) {
+        if (pos >= text.size() || text[pos] != c)
+            return false;
+        ++pos;
+        return true;
+    };
+    skip('-');
+    if (!skip('0') && !(pos < text.size() && text[pos] != '0' && digits()))
+        return false;
+    if (skip('.') && !digits())
+        return false;
+    if (skip('e') || skip('E')) {
+        if (!skip('+'))
+            skip('-');
+        if (!digits())
+            return false;
+    }
+    return pos == text.size();
+}
+
+int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+void appendUtf8(std::string& out, uint32_t codepoint)
+{
+    if (codepoint < 0x80) {
+        out += static_cast<char>(codepoint);
+    } else if (codepoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+/// Scanner relies on std::string having '\0' after the last character, so reading at data[size] is allowed.
+class Scanner {
+public:
+    explicit Scanner(const std::string& buffer)
+        : m_data(buffer.data())
+        , m_size(buffer.size())
+    {}
+
+    char        at(size_t pos) const { return m_data[pos]; }
+    const char* ptr(size_t pos) const { return m_data + pos; }
+
+    size_t skipSpace(size_t pos) const
+    {
+        while (isSpace(m_data[pos]))
+            ++pos;
+        return pos;
+    }
+
+    // pos points to opening quote; returns position after closing quote.
+    size_t skipString(size_t pos, bool& hasEscapes) const
+    {
+        hasEscapes = false;
+        ++pos;
+        while (true) {
+            const char c = m_data[pos];
+            if (c == '"')
+                return pos + 1;
+            if (c == '\\') {
+                if (pos + 1 >= m_size)
+                    throwError("unterminated string", pos);
+                hasEscapes = true;
+                pos += 2;
+                continue;
+            }
+            if (pos >= m_size)
+                throwError("unterminated string", pos);
+            ++pos;
+        }
+    }
+
+    // pos points to first character of value; returns position right after it.
+    // containers are skipped by bracket depth only, their content is validated when they are indexed.
+    size_t skipValue(size_t pos) const
+    {
+        const char first = m_data[pos];
+        bool       hasEscapes;
+        if (first == '"')
+            return skipString(pos, hasEscapes);
+        if (first != '{' && first != '[') {
+            const size_t start = pos;
+            while (!isValueEnd(m_data[pos]))
+                ++pos;
+            if (pos == start)
+                throwError("value expected", pos);
+            if (!isValidToken(std::string_view(m_data + start, pos - start)))
+                throwError("invalid scalar value", start);
+            return pos;
+        }
+        size_t depth = 0;
+        while (true) {
+            const char c = m_data[pos];
+            if (c == '"') {
+                pos = skipString(pos, hasEscapes);
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0)
+                    return pos + 1;
+            } else if (pos >= m_size) {
+                throwError("unexpected end of data", pos);
+            }
+            ++pos;
+        }
+    }
+
+    // decode string contents between quotes (begin is after opening quote).
+    std::string decodeString(size_t begin, size_t end) const
+    {
+        std::string result;
+        result.reserve(end - begin);
+        for (size_t pos = begin; pos < end; ++pos) {
+            const char c = m_data[pos];
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            const char e = m_data[++pos];
+            switch (e) {
+                case '"':
+                case '\\':
+                case '/':
+                    result += e;
+                    break;
+                case 'b':
+                    result += '\b';
+                    break;
+                case 'f':
+                    result += '\f';
+                    break;
+                case 'n':
+                    result += '\n';
+                    break;
+                case 'r':
+                    result += '\r';
+                    break;
+                case 't':
+                    result += '\t';
+                    break;
+                case 'u':
+                {
+                    uint32_t codepoint = parseHex4(pos + 1, end);
+                    pos += 4;
+                    if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                        if (pos + 2 >= end || m_data[pos + 1] != '\\' || m_data[pos + 2] != 'u')
+                            throwError("invalid surrogate pair", pos);
+                        const uint32_t low = parseHex4(pos + 3, end);
+                        if (low < 0xDC00 || low > 0xDFFF)
+                            throwError("invalid surrogate pair", pos);
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                        pos += 6;
+                    }
+                    appendUtf8(result, codepoint);
+                } break;
+                default:
+                    throwError("invalid escape sequence", pos);
+            }
+        }
+        return result;
+    }
+
+    // pos is advanced past the value.
+    PropertyTreeScalar parseScalar(size_t& pos) const
+    {
+        const size_t start = pos;
+        const char   first = m_data[start];
+        if (first == '"') {
+            bool hasEscapes;
+            pos              = skipString(start, hasEscapes);
+            const size_t end = pos - 1;
+            if (!hasEscapes)
+                return PropertyTreeScalar(std::string_view(m_data + start + 1, end - start - 1));
+            return PropertyTreeScalar(decodeString(start + 1, end));
+        }
+        pos = skipValue(start);
+        const std::string_view text(m_data + start, pos - start);
+        if (text == "true")
+            return PropertyTreeScalar(true);
+        if (text == "false")
+            return PropertyTreeScalar(false);
+
+        const char* begin = text.data();
+        const char* last  = text.data() + text.size();
+        if (text.find_first_of(".eE") == std::string_view::npos) {
+            int64_t ival = 0;
+            if (auto [ptr, ec] = std::from_chars(begin, last, ival); ec == std::errc() && ptr == last)
+                return PropertyTreeScalar(ival);
+            // same as rapidjson reader: values above int64 range are stored as wrapped uint64.
+            uint64_t uval = 0;
+            if (auto [ptr, ec] = std::from_chars(begin, last, uval); ec == std::errc() && ptr == last)
+                return PropertyTreeScalar(static_cast<int64_t>(uval));
+        }
+        double dval = 0.;
+        if (auto [ptr, ec] = std::from_chars(begin, last, dval); ec == std::errc() && ptr == last)
+            return PropertyTreeScalar(dval);
+
+        throwError("invalid scalar value", start);
+    }
+
+private:
+    uint32_t parseHex4(size_t pos, size_t end) const
+    {
+        if (pos + 4 > end)
+            throwError("invalid unicode escape", pos);
+        uint32_t result = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const int digit = hexDigit(m_data[pos + i]);
+            if (digit < 0)
+                throwError("invalid unicode escape", pos);
+            result = result * 16 + digit;
+        }
+        return result;
+    }
+
+    const char*  m_data;
+    const size_t m_size;
+};
+
+}
+
+struct JsonDocument::Index {
+    struct Child {
+        std::string_view m_key;
+        uint32_t         m_keyOffset   = JsonView::s_noKey;
+        uint32_t         m_valueOffset = 0;
+    };
+    std::vector<Child>      m_children;
+    std::vector<uint32_t>   m_sorted;        // for large maps: child indices ordered by key, duplicates in document order.
+    std::deque<std::string> m_decodedKeys;   // storage for keys with escape sequences.
+
+    void build(const Scanner& scanner, size_t offset)
+    {
+        const bool isMap = scanner.at(offset) == '{';
+        const char close = isMap ? '}' : ']';
+
+        size_t pos = scanner.skipSpace(offset + 1);
+        if (scanner.at(pos) == close)
+            return;
+        while (true) {
+            Child child;
+            if (isMap) {
+                if (scanner.at(pos) != '"')
+                    throwError("member name expected", pos);
+                bool         hasEscapes;
+                const size_t keyEnd = scanner.skipString(pos, hasEscapes) - 1;
+                child.m_keyOffset   = static_cast<uint32_t>(pos);
+                if (hasEscapes)
+                    child.m_key = m_decodedKeys.emplace_back(scanner.decodeString(pos + 1, keyEnd));
+                else
+                    child.m_key = std::string_view(scanner.ptr(pos + 1), keyEnd - pos - 1);
+
+                pos = scanner.skipSpace(keyEnd + 1);
+                if (scanner.at(pos) != ':')
+                    throwError("':' expected", pos);
+                pos = scanner.skipSpace(pos + 1);
+            }
+            child.m_valueOffset = static_cast<uint32_t>(pos);
+            pos                 = scanner.skipSpace(scanner.skipValue(pos));
+            m_children.push_back(child);
+
+            if (scanner.at(pos) == ',') {
+                pos = scanner.skipSpace(pos + 1);
+                continue;
+            }
+            if (scanner.at(pos) == close)
+                break;
+            throwError(isMap ? "',' or '}' expected" : "',' or ']' expected", pos);
+        }
+
+        if (isMap && m_children.size() > s_linearLookupSize) {
+            m_sorted.resize(m_children.size());
+            for (uint32_t i = 0; i < m_sorted.size(); ++i)
+                m_sorted[i] = i;
+            std::stable_sort(m_sorted.begin(), m_sorted.end(), [this](uint32_t l, uint32_t r) {
+                return m_children[l].m_key < m_children[r].m_key;
+            });
+        }
+    }
+
+    const Child* find(std::string_view key) const
+    {
+        // for duplicate keys the last one wins, same as for readJsonFromBuffer.
+        if (m_sorted.empty()) {
+            for (auto it = m_children.crbegin(); it != m_children.crend(); ++it) {
+                if (it->m_key == key)
+                    return &*it;
+            }
+            return nullptr;
+        }
+        auto it = std::upper_bound(m_sorted.cbegin(), m_sorted.cend(), key, [this](std::string_view k, uint32_t index) {
+            return k < m_children[index].m_key;
+        });
+        if (it == m_sorted.cbegin() || m_children[*(it - 1)].m_key != key)
+            return nullptr;
+        return &m_children[*(it - 1)];
+    }
+};
+
+struct JsonDocument::Cache {
+    std::mutex                                           m_mutex;
+    std::unordered_map<uint32_t, std::unique_ptr<Index>> m_indexes;
+};
+
+JsonDocument::JsonDocument(std::string buffer) noexcept(false)
+    : m_buffer(std::move(buffer))
+    , m_cache(std::make_unique<Cache>())
+{
+    if (m_buffer.size() >= JsonView::s_noKey)
+        throw std::runtime_error("JSON document is too large");
+
+    std::string_view data = m_buffer;
+    size_t           pos  = data.starts_with(std::string_view("\xef\xbb\xbf", 3)) ? 3 : 0;
+
+    Scanner scanner(m_buffer);
+    pos = scanner.skipSpace(pos);
+    if (scanner.at(pos) != '{' && scanner.at(pos) != '[')
+        throwError("object or array expected", pos);
+    m_rootOffset = static_cast<uint32_t>(pos);
+}
+
+JsonDocument::~JsonDocument() = default;
+
+JsonView JsonDocument::root() const noexcept(false)
+{
+    return JsonView(this, m_rootOffset, JsonView::s_noKey);
+}
+
+const JsonDocument::Index& JsonView::index() const noexcept(false)
+{
+    // index is immutable once built and never moves, so publishing the pointer is enough.
+    const JsonDocument::Index* cached = m_index.load(std::memory_order_acquire);
+    if (!cached) {
+        cached = &m_document->getIndex(m_offset);
+        m_index.store(cached, std::memory_order_release);
+    }
+    return *cached;
+}
+
+const JsonDocument::Index& JsonDocument::getIndex(uint32_t offset) const noexcept(false)
+{
+    std::lock_guard lock(m_cache->m_mutex);
+    auto&           index = m_cache->m_indexes[offset];
+    if (!index) {
+        auto built = std::make_unique<Index>();
+        built->build(Scanner(m_buffer), offset);
+        index = std::move(built);
+    }
+    return *index;
+}
+
+char JsonView::firstChar() const noexcept(false)
+{
+    if (!m_document)
+        throw std::runtime_error("Access to invalid JsonView");
+    return m_document->m_buffer[m_offset];
+}
+
+bool JsonView::isNull() const noexcept(false)
+{
+    return firstChar() == 'n';
+}
+
+bool JsonView::isScalar() const noexcept(false)
+{
+    const char c = firstChar();
+    return c != 'n' && c != '{' && c != '[';
+}
+
+bool JsonView::isList() const noexcept(false)
+{
+    return firstChar() == '[';
+}
+
+bool JsonView::isMap() const noexcept(false)
+{
+    return firstChar() == '{';
+}
+
+size_t JsonView::size() const noexcept(false)
+{
+    if (isScalar() || isNull())
+        return 0;
+    return index().m_children.size();
+}
+
+JsonView JsonView::find(std::string_view key) const noexcept(false)
+{
+    if (!isMap())
+        return {};
+    const auto* child = index().find(key);
+    if (!child)
+        return {};
+    return JsonView(m_document, child->m_valueOffset, child->m_keyOffset);
+}
+
+JsonView JsonView::operator[](std::string_view key) const noexcept(false)
+{
+    if (!isMap())
+        throw std::runtime_error("Invalid JsonView access, map expected");
+    JsonView result = find(key);
+    if (!result.isValid())
+        throw std::out_of_range("JsonView: key not found");
+    return result;
+}
+
+JsonView JsonView::operator[](size_t index) const noexcept(false)
+{
+    if (!isList())
+        throw std::runtime_error("Invalid JsonView access, list expected");
+    if (index >= size())
+        throw std::out_of_range("JsonView: index out of range");
+    return child(index);
+}
+
+JsonView JsonView::child(size_t index) const noexcept(false)
+{
+    const auto& child = this->index().m_children[index];
+    return JsonView(m_document, child.m_valueOffset, child.m_keyOffset);
+}
+
+std::string JsonView::key() const noexcept(false)
+{
+    if (!m_document || m_keyOffset == s_noKey)
+        return {};
+    Scanner      scanner(m_document->m_buffer);
+    bool         hasEscapes;
+    const size_t end = scanner.skipString(m_keyOffset, hasEscapes) - 1;
+    if (!hasEscapes)
+        return std::string(m_document->m_buffer, m_keyOffset + 1, end - m_keyOffset - 1);
+    return scanner.decodeString(m_keyOffset + 1, end);
+}
+
+PropertyTreeScalar JsonView::getScalar() const noexcept(false)
+{
+    if (!isScalar())
+        throw std::runtime_error("Invalid JsonView access, scalar expected");
+    size_t pos = m_offset;
+    return Scanner(m_document->m_buffer).parseScalar(pos);
+}
+
+PropertyTree JsonView::toPropertyTree() const noexcept(false)
+{
+    if (isNull())
+        return {};
+    if (isScalar())
+        return getScalar();
+
+    const auto& children = index().m_children;
+    if (isList()) {
+        PropertyTreeList list;
+        list.reserve(children.size());
+        for (const auto& child : children)
+            list.push_back(JsonView(m_document, child.m_valueOffset, child.m_keyOffset).toPropertyTree());
+        return PropertyTree(std::move(list));
+    }
+    PropertyTreeMap map;
+    map.reserve(children.size());
+    for (const auto& child : children)
+        map.appendUnsorted(PropertyTreeKey(child.m_key)) = JsonView(m_document, child.m_valueOffset, child.m_keyOffset).toPropertyTree();
+    map.sortAppended();
+    return PropertyTree(std::move(map));
+}
+
+std::string_view JsonView::raw() const noexcept(false)
+{
+    firstChar();
+    const size_t end = Scanner(m_document->m_buffer).skipValue(m_offset);
+    return std::string_view(m_document->m_buffer).substr(m_offset, end - m_offset);
+}
+
+JsonView JsonView::Iterator::operator*() const noexcept(false)
+{
+    return m_parent.child(m_index);
+}
+
+JsonCursor::JsonCursor(const std::string& buffer) noexcept(false)
+    : m_buffer(buffer)
+{
+    const size_t start = std::string_view(buffer).starts_with(std::string_view("\xef\xbb\xbf", 3)) ? 3 : 0;
+    m_pos              = Scanner(m_buffer).skipSpace(start);
+}
+
+char JsonCursor::peek() const noexcept
+{
+    return m_valuePending ? m_buffer[m_pos] : 0;
+}
+
+bool JsonCursor::isScalar() const noexcept
+{
+    const char c = peek();
+    return c != 0 && c != 'n' && c != '{' && c != '[';
+}
+
+bool JsonCursor::enterList() noexcept(false)
+{
+    if (!isList()) {
+        skip();
+        return false;
+    }
+    ++m_pos;
+    m_valuePending = false;
+    m_hasChildren.push_back(false);
+    return true;
+}
+
+bool JsonCursor::enterMap() noexcept(false)
+{
+    if (!isMap()) {
+        skip();
+        return false;
+    }
+    ++m_pos;
+    m_valuePending = false;
+    m_hasChildren.push_back(false);
+    return true;
+}
+
+bool JsonCursor::nextChild(char close) noexcept(false)
+{
+    if (m_hasChildren.empty())
+        throwError("no container was entered", m_pos);
+    skip();
+
+    Scanner scanner(m_buffer);
+    m_pos = scanner.skipSpace(m_pos);
+    if (scanner.at(m_pos) == close) {
+        ++m_pos;
+        m_hasChildren.pop_back();
+        return false;
+    }
+    if (m_hasChildren.back()) {
+        if (scanner.at(m_pos) != ',')
+            throwError(close == '}' ? "',' or '}' expected" : "',' or ']' expected", m_pos);
+        m_pos = scanner.skipSpace(m_pos + 1);
+    }
+    m_hasChildren.back() = true;
+    return true;
+}
+
+bool JsonCursor::nextElement() noexcept(false)
+{
+    if (!nextChild(']'))
+        return false;
+    m_valuePending = true;
+    return true;
+}
+
+bool JsonCursor::nextMember(std::string_view& key) noexcept(false)
+{
+    if (!nextChild('}'))
+        return false;
+
+    Scanner scanner(m_buffer);
+    if (scanner.at(m_pos) != '"')
+        throwError("member name expected", m_pos);
+    bool         hasEscapes;
+    const size_t keyEnd = scanner.skipString(m_pos, hasEscapes) - 1;
+    if (hasEscapes) {
+        m_decodedKey = scanner.decodeString(m_pos + 1, keyEnd);
+        key          = m_decodedKey;
+    } else {
+        key = std::string_view(scanner.ptr(m_pos + 1), keyEnd - m_pos - 1);
+    }
+    m_pos = scanner.skipSpace(keyEnd + 1);
+    if (scanner.at(m_pos) != ':')
+        throwError("':' expected", m_pos);
+    m_pos          = scanner.skipSpace(m_pos + 1);
+    m_valuePending = true;
+    return true;
+}
+
+PropertyTreeScalar JsonCursor::readScalar() noexcept(false)
+{
+    if (!isScalar())
+        throw std::runtime_error("Invalid JsonCursor access, scalar expected");
+    m_valuePending = false;
+    return Scanner(m_buffer).parseScalar(m_pos);
+}
+
+PropertyTree JsonCursor::readTree() noexcept(false)
+{
+    if (isScalar())
+        return readScalar();
+
+    if (isList()) {
+        PropertyTreeList list;
+        enterList();
+        while (nextElement())
+            list.push_back(readTree());
+        return PropertyTree(std::move(list));
+    }
+    if (isMap()) {
+        PropertyTreeMap map;
+        enterMap();
+        std::string_view key;
+        while (nextMember(key)) {
+            auto& child = map.appendUnsorted(PropertyTreeKey(key));
+            child       = readTree();
+        }
+        map.sortAppended();
+        return PropertyTree(std::move(map));
+    }
+    skip();
+    return {};
+}
+
+void JsonCursor::skip() noexcept(false)
+{
+    if (!m_valuePending)
+        return;
+    m_pos          = Scanner(m_buffer).skipValue(m_pos);
+    m_valuePending = false;
+}
+
+}
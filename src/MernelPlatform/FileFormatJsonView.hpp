@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "PropertyTree.hpp"
+
+#include "MernelPlatformExport.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mernel {
+
+class JsonView;
+
+/**
+ * @brief Raw JSON text with lazily built structural index.
+ *
+ * Unlike readJsonFromBuffer(), nothing is parsed at construction. Each object or array is scanned once, when it is first accessed
+ * through JsonView, and only the list of its direct children is remembered. Scalars are converted on every access.
+ * Errors in the parts of the document that were never touched are not detected; malformed data throws std::runtime_error on access.
+ *
+ * Document must outlive all views created from it. Accessing views from several threads is safe.
+ */
+class MERNELPLATFORM_EXPORT JsonDocument {
+public:
+    explicit JsonDocument(std::string buffer) noexcept(false);
+    ~JsonDocument();
+
+    JsonDocument(const JsonDocument&)            = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+
+    JsonView root() const noexcept(false);
+
+    const std::string& getBuffer() const noexcept { return m_buffer; }
+
+private:
+    friend class JsonView;
+    struct Index;
+
+    const Index& getIndex(uint32_t offset) const noexcept(false);
+
+    std::string m_buffer;
+    uint32_t    m_rootOffset = 0;
+
+    struct Cache;
+    std::unique_ptr<Cache> m_cache;
+};
+
+/**
+ * @brief Lightweight read-only reference to a value inside JsonDocument.
+ *
+ * Query surface is similar to const PropertyTree. Default-constructed view (or result of find() for missing key) is invalid.
+ */
+class MERNELPLATFORM_EXPORT JsonView {
+public:
+    JsonView() = default;
+    JsonView(const JsonView& rh) noexcept
+        : m_document(rh.m_document)
+        , m_offset(rh.m_offset)
+        , m_keyOffset(rh.m_keyOffset)
+        , m_index(rh.m_index.load(std::memory_order_acquire))
+    {}
+    JsonView& operator=(const JsonView& rh) noexcept
+    {
+        m_document  = rh.m_document;
+        m_offset    = rh.m_offset;
+        m_keyOffset = rh.m_keyOffset;
+        m_index.store(rh.m_index.load(std::memory_order_acquire), std::memory_order_release);
+        return *this;
+    }
+
+    [[nodiscard]] bool isValid() const noexcept { return m_document != nullptr; }
+
+    [[nodiscard]] bool isNull() const noexcept(false);
+    [[nodiscard]] bool isScalar() const noexcept(false);
+    [[nodiscard]] bool isList() const noexcept(false);
+    [[nodiscard]] bool isMap() const noexcept(false);
+
+    // number of elements in list or map, 0 for scalars.
+    size_t size() const noexcept(false);
+
+    bool     contains(std::string_view key) const noexcept(false) { return find(key).isValid(); }
+    JsonView find(std::string_view key) const noexcept(false);
+
+    // Will throw if no such key/index exists or value has another type.
+    JsonView operator[](std::string_view key) const noexcept(false);
+    JsonView operator[](size_t index) const noexcept(false);
+
+    // key of this value, if view is a map child obtained by iteration. Empty string otherwise.
+    std::string key() const noexcept(false);
+
+    // convert scalar value. Will throw for null, list or map.
+    PropertyTreeScalar getScalar() const noexcept(false);
+
+    // materialize value into PropertyTree (deep conversion).
+    PropertyTree toPropertyTree() const noexcept(false);
+
+    // raw JSON text of the value.
+    std::string_view raw() const noexcept(false);
+
+    class Iterator;
+
+    // iterate children of list or map. For map children key() returns member name.
+    Iterator begin() const noexcept;
+    Iterator end() const noexcept(false);
+
+private:
+    friend class JsonDocument;
+    JsonView(const JsonDocument* document, uint32_t offset, uint32_t keyOffset)
+        : m_document(document)
+        , m_offset(offset)
+        , m_keyOffset(keyOffset)
+    {}
+
+    char                       firstChar() const noexcept(false);
+    JsonView                   child(size_t index) const noexcept(false);
+    const JsonDocument::Index& index() const noexcept(false);
+
+    static constexpr uint32_t s_noKey = UINT32_MAX;
+
+    const JsonDocument* m_document  = nullptr;
+    uint32_t            m_offset    = 0;
+    uint32_t            m_keyOffset = s_noKey;
+
+    // index of this list or map, looked up in the document once per view (and its copies made after that).
+    mutable std::atomic<const JsonDocument::Index*> m_index = nullptr;
+};
+
+class MERNELPLATFORM_EXPORT JsonView::Iterator {
+public:
+    JsonView  operator*() const noexcept(false);
+    Iterator& operator++() noexcept
+    {
+        ++m_index;
+        return *this;
+    }
+    bool operator==(const Iterator& rh) const noexcept { return m_index == rh.m_index; }
+
+private:
+    friend class JsonView;
+    Iterator(const JsonView& parent, size_t index)
+        : m_parent(parent)
+        , m_index(index)
+    {}
+
+    JsonView m_parent;
+    size_t   m_index = 0;
+};
+
+inline JsonView::Iterator JsonView::begin() const noexcept
+{
+    return Iterator(*this, 0);
+}
+inline JsonView::Iterator JsonView::end() const noexcept(false)
+{
+    return Iterator(*this, size());
+}
+
+/**
+ * @brief Forward-only pull reader over JSON text.
+ *
+ * Cursor walks the document once without building any DOM or index, so it is suitable for reading data straight into user structures.
+ * Typical object traversal:
+ *
+ * if (cursor.enterMap()) {
+ *     std::string_view key;
+ *     while (cursor.nextMember(key)) {
+ *         if (key == "id")
+ *             id = cursor.readScalar().toInt();
+ *         // unread values are skipped automatically.
+ *     }
+ * }
+ *
+ * Buffer must outlive the cursor. Malformed data throws std::runtime_error.
+ */
+class MERNELPLATFORM_EXPORT JsonCursor {
+public:
+    explicit JsonCursor(const std::string& buffer) noexcept(false);
+
+    // type of current value.
+    [[nodiscard]] bool isNull() const noexcept { return peek() == 'n'; }
+    [[nodiscard]] bool isScalar() const noexcept;
+    [[nodiscard]] bool isList() const noexcept { return peek() == '['; }
+    [[nodiscard]] bool isMap() const noexcept { return peek() == '{'; }
+
+    // start reading of list or map. If current value has another type, skips it and returns false.
+    bool enterList() noexcept(false);
+    bool enterMap() noexcept(false);
+
+    // move to next list element or map member. Returns false (and leaves the container) when there are no more children.
+    // key view is valid until the next call.
+    bool nextElement() noexcept(false);
+    bool nextMember(std::string_view& key) noexcept(false);
+
+    // consume current value. readScalar will throw for null, list or map.
+    PropertyTreeScalar readScalar() noexcept(false);
+    PropertyTree       readTree() noexcept(false);
+    void               skip() noexcept(false);
+
+private:
+    char peek() const noexcept;
+    bool nextChild(char close) noexcept(false);
+
+    const std::string& m_buffer;
+    size_t             m_pos          = 0;
+    bool               m_valuePending = true;
+    std::vector<bool>  m_hasChildren;
+    std::string        m_decodedKey;
+};
+
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Mernel {
+
+/**
+ * @brief Associative container with std::map interface, which keeps sorted key-value pairs in one contiguous vector.
+ *
+ * Lookup is a binary search, iteration is a linear scan over memory, so it is much more cache-friendly than red-black tree
+ * for small and medium maps, which are built once and then mostly read.
+ * Insertion of key greater than all existing ones is amortized O(1), arbitrary insertion and erase are O(N).
+ *
+ * Differences from std::map (see StableMap for a std::map with the same interface):
+ * - any insertion or erase invalidates iterators and references to elements;
+ * - value_type is std::pair<Key, Value> (key is not const), do not modify the key through the iterator.
+ */
+template<class Key, class Value, class Compare = std::less<>, class Allocator = std::allocator<std::pair<Key, Value>>>
+class FlatMap {
+public:
+    using key_type        = Key;
+    using mapped_type     = Value;
+    using value_type      = std::pair<Key, Value>;
+    using key_compare     = Compare;
+    using allocator_type  = Allocator;
+    using container_type  = std::vector<value_type, Allocator>;
+    using size_type       = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+
+    using iterator               = typename container_type::iterator;
+    using const_iterator         = typename container_type::const_iterator;
+    using reverse_iterator       = typename container_type::reverse_iterator;
+    using const_reverse_iterator = typename container_type::const_reverse_iterator;
+
+public:
+    FlatMap() = default;
+    explicit FlatMap(const Allocator& allocator)
+        : m_data(allocator)
+    {}
+    FlatMap(std::initializer_list<value_type> list)
+    {
+        m_data.reserve(list.size());
+        for (const auto& p : list)
+            insert_or_assign(p.first, p.second);
+    }
+
+    iterator               begin() noexcept { return m_data.begin(); }
+    const_iterator         begin() const noexcept { return m_data.begin(); }
+    const_iterator         cbegin() const noexcept { return m_data.cbegin(); }
+    iterator               end() noexcept { return m_data.end(); }
+    const_iterator         end() const noexcept { return m_data.end(); }
+    const_iterator         cend() const noexcept { return m_data.cend(); }
+    reverse_iterator       rbegin() noexcept { return m_data.rbegin(); }
+    const_reverse_iterator rbegin() const noexcept { return m_data.rbegin(); }
+    reverse_iterator       rend() noexcept { return m_data.rend(); }
+    const_reverse_iterator rend() const noexcept { return m_data.rend(); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_data.empty(); }
+    size_type          size() const noexcept { return m_data.size(); }
+    size_type          capacity() const noexcept { return m_data.capacity(); }
+
+    void reserve(size_type size) { m_data.reserve(size); }
+    void shrink_to_fit() { m_data.shrink_to_fit(); }
+    void clear() noexcept { m_data.clear(); }
+
+    allocator_type get_allocator() const noexcept { return m_data.get_allocator(); }
+
+    /// Underlying sorted storage.
+    const container_type& data() const noexcept { return m_data; }
+
+    template<class K>
+    iterator lower_bound(const K& key)
+    {
+        return std::lower_bound(m_data.begin(), m_data.end(), key, KeyLess{});
+    }
+    template<class K>
+    const_iterator lower_bound(const K& key) const
+    {
+        return std::lower_bound(m_data.begin(), m_data.end(), key, KeyLess{});
+    }
+
+    template<class K>
+    iterator find(const K& key)
+    {
+        auto it = lower_bound(key);
+        return (it != m_data.end() && !Compare{}(key, it->first)) ? it : m_data.end();
+    }
+    template<class K>
+    const_iterator find(const K& key) const
+    {
+        auto it = lower_bound(key);
+        return (it != m_data.end() && !Compare{}(key, it->first)) ? it : m_data.end();
+    }
+
+    template<class K>
+    bool contains(const K& key) const
+    {
+        return find(key) != m_data.end();
+    }
+    template<class K>
+    size_type count(const K& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template<class K>
+    Value& at(const K& key)
+    {
+        auto it = find(key);
+        if (it == m_data.end())
+            throw std::out_of_range("FlatMap::at: key not found");
+        return it->second;
+    }
+    template<class K>
+    const Value& at(const K& key) const
+    {
+        auto it = find(key);
+        if (it == m_data.end())
+            throw std::out_of_range("FlatMap::at: key not found");
+        return it->second;
+    }
+
+    template<class K>
+    Value& operator[](K&& key)
+    {
+        return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        // appending in sorted order is the common case when map is read from file or built from sorted source.
+        if (m_data.empty() || Compare{}(m_data.back().first, key)) {
+            m_data.emplace_back(std::piecewise_construct,
+                                std::forward_as_tuple(std::forward<K>(key)),
+                                std::forward_as_tuple(std::forward<Args>(args)...));
+            return { m_data.end() - 1, true };
+        }
+        auto it = lower_bound(key);
+        if (it != m_data.end() && !Compare{}(key, it->first))
+            return { it, false };
+
+        it = m_data.emplace(it,
+                            std::piecewise_construct,
+                            std::forward_as_tuple(std::forward<K>(key)),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+        return { it, true };
+    }
+
+    template<class K, class V>
+    std::pair<iterator, bool> insert_or_assign(K&& key, V&& value)
+    {
+        auto result = try_emplace(std::forward<K>(key), std::forward<V>(value));
+        if (!result.second)
+            result.first->second = std::forward<V>(value);
+        return result;
+    }
+
+    template<class K, class V>
+    std::pair<iterator, bool> emplace(K&& key, V&& value)
+    {
+        return try_emplace(std::forward<K>(key), std::forward<V>(value));
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(std::move(value.first), std::move(value.second)); }
+
+    iterator erase(iterator it) { return m_data.erase(it); }
+    iterator erase(const_iterator it) { return m_data.erase(it); }
+    iterator erase(const_iterator first, const_iterator last) { return m_data.erase(first, last); }
+
+    template<class K>
+    size_type erase(const K& key)
+    {
+        auto it = find(key);
+        if (it == m_data.end())
+            return 0;
+        m_data.erase(it);
+        return 1;
+    }
+
+    /// Elements are visited in key order, each exactly once and before it is moved, so predicate may keep a position counter.
+    template<class Predicate>
+    size_type erase_if(Predicate pred)
+    {
+        auto out = m_data.begin();
+        for (auto it = m_data.begin(); it != m_data.end(); ++it) {
+            if (pred(std::as_const(*it)))
+                continue;
+            if (out != it)
+                *out = std::move(*it);
+            ++out;
+        }
+        const size_type count = m_data.end() - out;
+        m_data.erase(out, m_data.end());
+        return count;
+    }
+
+    /// Bulk construction: append elements in any order with appendUnsorted(), then call sortAppended() once before any lookup.
+    /// For duplicate keys the last appended value wins, same as for sequential operator[] assignment.
+    template<class K>
+    Value& appendUnsorted(K&& key)
+    {
+        return m_data.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple()).second;
+    }
+    void sortAppended()
+    {
+        auto notLess = [](const value_type& l, const value_type& r) { return !Compare{}(l.first, r.first); };
+        auto less    = [](const value_type& l, const value_type& r) { return Compare{}(l.first, r.first); };
+        auto broken  = std::adjacent_find(m_data.begin(), m_data.end(), notLess);
+        if (broken == m_data.end())
+            return;
+
+        // sorted keys appended to a sorted map: merge in linear time.
+        if (std::adjacent_find(broken + 1, m_data.end(), notLess) == m_data.end())
+            std::inplace_merge(m_data.begin(), broken + 1, m_data.end(), less);
+        else
+            std::stable_sort(m_data.begin(), m_data.end(), less);
+        auto out = m_data.begin();
+        for (auto it = m_data.begin(); it != m_data.end(); ++it) {
+            auto next = it + 1;
+            if (next != m_data.end() && !Compare{}(it->first, next->first))
+                continue;
+            if (out != it)
+                *out = std::move(*it);
+            ++out;
+        }
+        m_data.erase(out, m_data.end());
+    }
+
+    bool operator==(const FlatMap& rh) const { return m_data == rh.m_data; }
+
+private:
+    struct KeyLess {
+        template<class K>
+        bool operator()(const value_type& element, const K& key) const
+        {
+            return Compare{}(element.first, key);
+        }
+    };
+
+    container_type m_data;
+};
+
+}
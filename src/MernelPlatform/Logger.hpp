@@ -6,6 +6,7 @@
 #pragma once
 
 #include "MernelPlatformExport.hpp"
+#include "NumberFormat.hpp"
 
 #include <string>
 #include <vector>
@@ -75,8 +76,17 @@ public:
     template<class Data>
     Logger& operator<<(const Data& D)
     {
-        if (m_stream)
-            *m_stream << D;
+        if (!m_stream)
+            return *this;
+        // numbers skip iostream formatting unless flags, precision or width were changed with manipulators; char types are printed as chars.
+        if constexpr (FormattableNumber<Data> && (sizeof(Data) > 1 || !std::is_integral_v<Data>)) {
+            if (hasDefaultFormat()) {
+                char buffer[s_numberBufferSize];
+                m_stream->write(buffer, formatNumber(buffer, D) - buffer);
+                return *this;
+            }
+        }
+        *m_stream << D;
         return *this;
     }
     template<class Data>
@@ -89,6 +99,10 @@ private:
     int                                 m_logLevel{};
 
     void flush();
+    bool hasDefaultFormat() const
+    {
+        return m_stream->flags() == (std::ios_base::skipws | std::ios_base::dec) && m_stream->precision() == 6 && m_stream->width() == 0;
+    }
 
     Logger(const Logger&)         = delete;
     void operator=(const Logger&) = delete;
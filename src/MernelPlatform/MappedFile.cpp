@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MappedFile.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Mernel {
+
+MappedFile::MappedFile(const std_path& path) noexcept(false)
+{
+    if (!open(path))
+        throw std::runtime_error("Failed to map file: " + path2string(path));
+}
+
+MappedFile::MappedFile(MappedFile&& another) noexcept
+    : m_data(std::exchange(another.m_data, nullptr))
+    , m_size(std::exchange(another.m_size, 0))
+    , m_isOpen(std::exchange(another.m_isOpen, false))
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& another) noexcept
+{
+    if (this != &another) {
+        close();
+        m_data   = std::exchange(another.m_data, nullptr);
+        m_size   = std::exchange(another.m_size, 0);
+        m_isOpen = std::exchange(another.m_isOpen, false);
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std_path& path) noexcept(true)
+{
+    close();
+    HANDLE file = ::CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize{};
+    if (!::GetFileSizeEx(file, &fileSize) || static_cast<uint64_t>(fileSize.QuadPart) > (std::numeric_limits<size_t>::max)()) {
+        ::CloseHandle(file);
+        return false;
+    }
+    if (fileSize.QuadPart == 0) {
+        ::CloseHandle(file);
+        m_isOpen = true;
+        return true;
+    }
+
+    // view keeps mapping object alive, so both handles can be closed right away.
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(file);
+    if (!mapping)
+        return false;
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mapping);
+    if (!view)
+        return false;
+
+    m_data   = static_cast<const uint8_t*>(view);
+    m_size   = static_cast<size_t>(fileSize.QuadPart);
+    m_isOpen = true;
+    return true;
+}
+
+void MappedFile::close() noexcept(true)
+{
+    if (m_data)
+        ::UnmapViewOfFile(m_data);
+    m_data   = nullptr;
+    m_size   = 0;
+    m_isOpen = false;
+}
+
+#else
+
+bool MappedFile::open(const std_path& path) noexcept(true)
+{
+    close();
+    const int fd = ::open(path2string(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat fileStat {};
+    if (::fstat(fd, &fileStat) != 0 || static_cast<uint64_t>(fileStat.st_size) > (std::numeric_limits<size_t>::max)()) {
+        ::close(fd);
+        return false;
+    }
+    if (fileStat.st_size == 0) {
+        ::close(fd);
+        m_isOpen = true;
+        return true;
+    }
+
+    const size_t size = static_cast<size_t>(fileStat.st_size);
+    void*        view = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // mapping stays valid after descriptor is closed.
+    ::close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    m_data   = static_cast<const uint8_t*>(view);
+    m_size   = size;
+    m_isOpen = true;
+    return true;
+}
+
+void MappedFile::close() noexcept(true)
+{
+    if (m_data)
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data   = nullptr;
+    m_size   = 0;
+    m_isOpen = false;
+}
+
+#endif
+
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "FsUtils.hpp"
+
+#include "MernelPlatformExport.hpp"
+
+#include <cstdint>
+#include <span>
+
+namespace Mernel {
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Pages are loaded on access and are shared through page cache with other processes mapping the same file,
+ * so large files are parsed without reading them into memory first.
+ *
+ * General usage:
+ *
+ * MappedFile                file(path);
+ * ByteOrderBuffer           buffer(file.data());
+ * ByteOrderDataStreamReader stream(buffer, ByteOrderDataStream::s_littleEndian);
+ */
+class MERNELPLATFORM_EXPORT MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std_path& path) noexcept(false);
+    ~MappedFile() { close(); }
+
+    MappedFile(MappedFile&& another) noexcept;
+    MappedFile& operator=(MappedFile&& another) noexcept;
+
+    /// Empty file is opened successfully, with empty data.
+    bool open(const std_path& path) noexcept(true);
+    void close() noexcept(true);
+
+    bool isOpen() const { return m_isOpen; }
+
+    /// Valid until file is closed.
+    std::span<const uint8_t> data() const { return { m_data, m_size }; }
+    size_t                   size() const { return m_size; }
+
+private:
+    MappedFile(const MappedFile& another)            = delete;
+    MappedFile& operator=(const MappedFile& another) = delete;
+
+    const uint8_t* m_data   = nullptr;
+    size_t         m_size   = 0;
+    bool           m_isOpen = false;
+};
+
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace Mernel {
+
+/// Number <-> text conversion based on std::to_chars/std::from_chars: locale-independent, no allocations and no streams.
+/// Floating point values are written in the shortest form which reads back to exactly the same value.
+
+template<class T>
+concept FormattableNumber = (std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_same_v<T, double> || std::is_same_v<T, float>;
+
+/// Enough for any integer up to 64 bits or shortest double ("-2.2250738585072014e-308").
+constexpr size_t s_numberBufferSize = 32;
+
+/// Writes value into buffer of s_numberBufferSize chars; returns end of the written text (no terminating zero).
+inline char* formatNumber(char* buffer, FormattableNumber auto value) noexcept
+{
+    return std::to_chars(buffer, buffer + s_numberBufferSize, value).ptr;
+}
+
+inline void appendNumber(std::string& output, FormattableNumber auto value)
+{
+    char buffer[s_numberBufferSize];
+    output.append(buffer, formatNumber(buffer, value));
+}
+
+inline std::string numberToString(FormattableNumber auto value)
+{
+    std::string result;
+    appendNumber(result, value);
+    return result;
+}
+
+/// Same as formatNumber, but integral double gets ".0" suffix ("2.0", not "2"), so text is not read back as integer.
+inline char* formatDoubleWithPoint(char* buffer, double value) noexcept
+{
+    char* end = formatNumber(buffer, value);
+    // exponent form and nan/inf already are not integers.
+    if (std::string_view(buffer, end - buffer).find_first_not_of("-0123456789") == std::string_view::npos) {
+        *end++ = '.';
+        *end++ = '0';
+    }
+    return end;
+}
+
+inline void appendDoubleWithPoint(std::string& output, double value)
+{
+    char buffer[s_numberBufferSize + 2];
+    output.append(buffer, formatDoubleWithPoint(buffer, value));
+}
+
+/// Parses number surrounded by optional spaces; leading '+' is allowed. Returns false (value is unchanged) if text is not a number
+/// or does not fit into T. With allowTrailing, any text after the number is ignored, like for atoi/strtod.
+template<FormattableNumber T>
+inline bool parseNumber(std::string_view str, T& value, bool allowTrailing = false) noexcept
+{
+    const size_t first = str.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos)
+        return false;
+    str.remove_prefix(first);
+    if (str.starts_with('+') && !str.starts_with("+-"))
+        str.remove_prefix(1);
+
+    T          result{};
+    const auto end       = str.data() + str.size();
+    const auto [ptr, ec] = std::from_chars(str.data(), end, result);
+    if (ec != std::errc())
+        return false;
+    if (!allowTrailing && std::string_view(ptr, end - ptr).find_first_not_of(" \t\r\n") != std::string_view::npos)
+        return false;
+    value = result;
+    return true;
+}
+
+}
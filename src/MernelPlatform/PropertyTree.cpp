@@ -5,20 +5,218 @@
  */
 #include "PropertyTree.hpp"
 
+#include "NumberFormat.hpp"
+
+#include <bit>
 #include <iostream>
+#include <iterator>
 #include <cstdint>
+#include <type_traits>
+
+#ifdef USE_ZSTD
+#define XXH_STATIC_LINKING_ONLY
+#include <common/xxhash.h>
+#endif
 
 namespace Mernel {
 
 namespace {
-static const std::string s_empty;
+constexpr size_t s_linearLookupSize = 16;
+
+// streaming 64-bit hash: xxHash64 from zstd when available, FNV-1a otherwise.
+class Hasher {
+public:
+#ifdef USE_ZSTD
+    Hasher() noexcept { XXH64_reset(&m_state, 0); }
+    void     update(const void* data, size_t size) noexcept { XXH64_update(&m_state, data, size); }
+    uint64_t digest() const noexcept { return XXH64_digest(&m_state); }
+#else
+    void update(const void* data, size_t size) noexcept
+    {
+        for (size_t i = 0; i < size; ++i)
+            m_state = (m_state ^ static_cast<const uint8_t*>(data)[i]) * 0x100000001b3ULL;
+    }
+    uint64_t digest() const noexcept { return m_state; }
+#endif
+
+    template<class T>
+    void updatePod(T value) noexcept
+    {
+        update(&value, sizeof(T));
+    }
+    // size goes first, so concatenation of adjacent strings is not ambiguous.
+    void updateString(std::string_view value) noexcept
+    {
+        updatePod(static_cast<uint64_t>(value.size()));
+        update(value.data(), value.size());
+    }
+
+    void updateScalar(const PropertyTreeScalar& scalar) noexcept
+    {
+        if (scalar.isString()) {
+            updatePod('s');
+            updateString(scalar.toStringView());
+        } else if (scalar.isBool()) {
+            updatePod('b');
+            updatePod(scalar.toBool());
+        } else if (scalar.isInt()) {
+            updatePod('i');
+            updatePod(scalar.toInt());
+        } else if (scalar.isDouble()) {
+            // -0.0 == 0.0, so they must hash the same.
+            const double value = scalar.toDouble();
+            updatePod('d');
+            updatePod(value == 0. ? 0. : value);
+        } else {
+            updatePod('n');
+        }
+    }
+
+    // nested containers contribute their own (possibly cached) hash.
+    void updateTree(const PropertyTree& tree) noexcept
+    {
+        if (tree.isScalar())
+            updateScalar(tree.getScalar());
+        else if (tree.isList() || tree.isMap())
+            updatePod(tree.hash());
+        else
+            updatePod('0');
+    }
+
+    void updateContainer(const PropertyTreeList& list) noexcept
+    {
+        updatePod('[');
+        updatePod(static_cast<uint64_t>(list.size()));
+        for (const PropertyTree& child : list)
+            updateTree(child);
+    }
+    void updateContainer(const PropertyTreeMap& map) noexcept
+    {
+        updatePod('{');
+        updatePod(static_cast<uint64_t>(map.size()));
+        for (const auto& [key, child] : map) {
+            updateString(key.view());
+            updateTree(child);
+        }
+    }
+
+private:
+#ifdef USE_ZSTD
+    XXH64_state_t m_state;
+#else
+    uint64_t m_state = 0xcbf29ce484222325ULL;
+#endif
+};
+
+// erases elements which index is marked in remove, keeping order; elements past remove.size() are kept.
+void eraseMarked(PropertyTreeMap& map, const std::vector<bool>& remove)
+{
+    // erase_if visits elements in order, once each.
+    size_t index = 0;
+    map.erase_if([&remove, &index](const auto&) {
+        const bool erase = index < remove.size() && remove[index];
+        ++index;
+        return erase;
+    });
+}
+
+// calls func(oneIndex, oneValue, twoIndex, twoValue) for keys present in both maps, using a single merge pass over sorted maps.
+// returns true if maps have the same set of keys.
+template<class Func>
+bool forCommonKeys(PropertyTreeMap& oneMap, PropertyTreeMap& twoMap, Func&& func)
+{
+    bool   sameKeys = oneMap.size() == twoMap.size();
+    auto   oneIt    = oneMap.begin();
+    auto   twoIt    = twoMap.begin();
+    size_t oneIndex = 0;
+    size_t twoIndex = 0;
+    while (oneIt != oneMap.end() && twoIt != twoMap.end()) {
+        if (oneIt->first < twoIt->first) {
+            sameKeys = false;
+            ++oneIt, ++oneIndex;
+        } else if (twoIt->first < oneIt->first) {
+            sameKeys = false;
+            ++twoIt, ++twoIndex;
+        } else {
+            func(oneIndex, oneIt->second, twoIndex, twoIt->second);
+            ++oneIt, ++oneIndex;
+            ++twoIt, ++twoIndex;
+        }
+    }
+    return sameKeys;
+}
+
+// returns true if trees were equal (then both are reset to null).
+bool removeEqualValuesImpl(PropertyTree& one, PropertyTree& two)
+{
+    // same node, or equal cached hashes confirmed by comparison: nothing to recurse into and nothing gets unshared.
+    // Different hashes do not allow to skip recursion, as children still may be equal.
+    const auto oneHash = one.cachedHash();
+    const auto twoHash = two.cachedHash();
+    if (one.isSharedWith(two) || (oneHash && twoHash && *oneHash == *twoHash && one == two)) {
+        one = {};
+        two = {};
+        return true;
+    }
+    if (one.isMap() && two.isMap()) {
+        auto& oneMap = one.getMap();
+        auto& twoMap = two.getMap();
+
+        bool       allEqual = true;
+        bool       anyEqual = false;
+        const bool sameKeys = forCommonKeys(oneMap, twoMap, [&allEqual, &anyEqual](size_t, PropertyTree& oneValue, size_t, PropertyTree& twoValue) {
+            const bool equal = removeEqualValuesImpl(oneValue, twoValue);
+            allEqual         = allEqual && equal;
+            anyEqual         = anyEqual || equal;
+        });
+        if (sameKeys && allEqual) {
+            one = {};
+            two = {};
+            return true;
+        }
+        if (!anyEqual)
+            return false;
+
+        // equal pairs were reset to null; unequal pair never ends up with both values null.
+        std::vector<bool> oneRemove(oneMap.size()), twoRemove(twoMap.size());
+        forCommonKeys(oneMap, twoMap, [&oneRemove, &twoRemove](size_t oneIndex, PropertyTree& oneValue, size_t twoIndex, PropertyTree& twoValue) {
+            const bool equal    = oneValue.isNull() && twoValue.isNull();
+            oneRemove[oneIndex] = equal;
+            twoRemove[twoIndex] = equal;
+        });
+        eraseMarked(oneMap, oneRemove);
+        eraseMarked(twoMap, twoRemove);
+        return false;
+    }
+    if (one.isList() && two.isList()) {
+        auto& oneList = one.getList();
+        auto& twoList = two.getList();
+
+        bool       allEqual = oneList.size() == twoList.size();
+        const auto minSize  = std::min(oneList.size(), twoList.size());
+        for (size_t i = 0; i < minSize; ++i)
+            allEqual = removeEqualValuesImpl(oneList[i], twoList[i]) && allEqual;
+        if (allEqual) {
+            one = {};
+            two = {};
+            return true;
+        }
+        return false;
+    }
+    if (one == two) {
+        one = {};
+        two = {};
+        return true;
+    }
+    return false;
+}
 
 static inline char toHex(uint8_t c)
 {
     return (c <= 9) ? '0' + c : 'a' + c - 10;
 }
 
-void printJsonString(std::ostream& os, const std::string& value, bool addQuotes, bool escapeString)
+void printJsonString(std::ostream& os, std::string_view value, bool addQuotes, bool escapeString)
 {
     if (addQuotes)
         os << '"';
@@ -31,6 +229,8 @@ void printJsonString(std::ostream& os, const std::string& value, bool addQuotes,
                 os << "\\u00" << toHex(byte / 16) << toHex(byte % 16);
             } else if (byte == '\\') {
                 os << "\\\\";
+            } else if (byte == '"' && addQuotes) {
+                os << "\\\"";
             } else {
                 os << c;
             }
@@ -43,85 +243,199 @@ void printJsonString(std::ostream& os, const std::string& value, bool addQuotes,
 }
 }
 
+PropertyTreeScalar PropertyTreeScalar::borrowed(std::string_view value) noexcept(false)
+{
+    assert(value.data() && value.data()[value.size()] == 0);
+    if (value.size() > UINT32_MAX)
+        throw std::length_error("PropertyTreeScalar: string is too long");
+
+    PropertyTreeScalar result;
+    result.setExternal(Type::StringBorrowed, value.data(), value.size());
+    return result;
+}
+
+void PropertyTreeScalar::setString(std::string_view value) noexcept(false)
+{
+    if (value.size() <= s_inlineCapacity) {
+        std::memcpy(m_storage, value.data(), value.size());
+        m_storage[value.size()] = 0;
+        m_inlineSize            = static_cast<uint8_t>(value.size());
+        m_type                  = Type::StringInline;
+        return;
+    }
+    if (value.size() > UINT32_MAX)
+        throw std::length_error("PropertyTreeScalar: string is too long");
+
+    char* data = new char[value.size() + 1];
+    std::memcpy(data, value.data(), value.size());
+    data[value.size()] = 0;
+    setExternal(Type::StringHeap, data, value.size());
+}
+
+void PropertyTreeScalar::setExternal(Type type, const char* data, size_t size) noexcept
+{
+    const uint32_t size32 = static_cast<uint32_t>(size);
+    std::memcpy(m_storage, &data, sizeof(data));
+    std::memcpy(m_storage + sizeof(data), &size32, sizeof(size32));
+    m_type = type;
+}
+
+void PropertyTreeScalar::copyFrom(const PropertyTreeScalar& rh) noexcept(false)
+{
+    if (rh.m_type == Type::StringHeap || rh.m_type == Type::StringBorrowed) {
+        setString(rh.toStringView());
+        return;
+    }
+    std::memcpy(m_storage, rh.m_storage, sizeof(m_storage));
+    m_inlineSize = rh.m_inlineSize;
+    m_type       = rh.m_type;
+}
+
+void PropertyTreeScalar::moveFrom(PropertyTreeScalar& rh) noexcept
+{
+    // heap pointer is just transferred, so move never allocates.
+    std::memcpy(m_storage, rh.m_storage, sizeof(m_storage));
+    m_inlineSize = rh.m_inlineSize;
+    m_type       = rh.m_type;
+    rh.m_type    = Type::Null;
+}
+
+void PropertyTreeScalar::reset() noexcept
+{
+    if (m_type == Type::StringHeap)
+        delete[] getPod<const char*>();
+    m_type = Type::Null;
+}
+
+bool PropertyTreeScalar::operator==(const PropertyTreeScalar& rh) const noexcept
+{
+    if (isString() && rh.isString())
+        return toStringView() == rh.toStringView();
+    if (m_type != rh.m_type)
+        return false;
+    switch (m_type) {
+        case Type::Bool:
+            return getPod<bool>() == rh.getPod<bool>();
+        case Type::Int:
+            return getPod<int64_t>() == rh.getPod<int64_t>();
+        case Type::Double:
+            return getPod<double>() == rh.getPod<double>();
+        default:
+            break;
+    }
+    return true;
+}
+
+uint64_t PropertyTreeScalar::hash() const noexcept
+{
+    Hasher hasher;
+    hasher.updateScalar(*this);
+    return hasher.digest();
+}
+
 bool PropertyTreeScalar::toBool() const noexcept
 {
-    if (const auto* bval = std::get_if<bool>(&m_data); bval)
-        return *bval;
-    if (const auto* ival = std::get_if<int64_t>(&m_data); ival)
-        return *ival;
-    if (const auto* dval = std::get_if<double>(&m_data); dval)
-        return *dval;
+    switch (m_type) {
+        case Type::Bool:
+            return getPod<bool>();
+        case Type::Int:
+            return getPod<int64_t>();
+        case Type::Double:
+            return getPod<double>();
+        default:
+            break;
+    }
     return false;
 }
 
-const std::string& PropertyTreeScalar::toString() const noexcept
+std::string PropertyTreeScalar::toString() const noexcept(false)
 {
-    if (const auto* sval = std::get_if<std::string>(&m_data); sval)
-        return *sval;
-    return s_empty;
+    return std::string(toStringView());
+}
+
+std::string_view PropertyTreeScalar::toStringView() const noexcept
+{
+    if (m_type == Type::StringInline)
+        return std::string_view(m_storage, m_inlineSize);
+    if (m_type == Type::StringHeap || m_type == Type::StringBorrowed) {
+        uint32_t size;
+        std::memcpy(&size, m_storage + sizeof(const char*), sizeof(size));
+        return std::string_view(getPod<const char*>(), size);
+    }
+    return {};
 }
 
 const char* PropertyTreeScalar::toCString() const noexcept
 {
-    if (const auto* sval = std::get_if<std::string>(&m_data); sval)
-        return sval->c_str();
-    return nullptr;
+    if (!isString())
+        return nullptr;
+    return toStringView().data();
 }
 
 int64_t PropertyTreeScalar::toInt() const noexcept
 {
-    if (const auto* ival = std::get_if<int64_t>(&m_data); ival)
-        return *ival;
-    if (const auto* bval = std::get_if<bool>(&m_data); bval)
-        return *bval;
-    if (const auto* dval = std::get_if<double>(&m_data); dval)
-        return static_cast<int64_t>(*dval);
+    switch (m_type) {
+        case Type::Int:
+            return getPod<int64_t>();
+        case Type::Bool:
+            return getPod<bool>();
+        case Type::Double:
+            return static_cast<int64_t>(getPod<double>());
+        default:
+            break;
+    }
     return 0;
 }
 
 double PropertyTreeScalar::toDouble() const noexcept
 {
-    if (const auto* dval = std::get_if<double>(&m_data); dval)
-        return *dval;
-    if (const auto* ival = std::get_if<int64_t>(&m_data); ival)
-        return static_cast<double>(*ival);
-    if (const auto* bval = std::get_if<bool>(&m_data); bval)
-        return *bval;
+    switch (m_type) {
+        case Type::Double:
+            return getPod<double>();
+        case Type::Int:
+            return static_cast<double>(getPod<int64_t>());
+        case Type::Bool:
+            return getPod<bool>();
+        default:
+            break;
+    }
     return 0.;
 }
 
 std::string PropertyTreeScalar::dump() const noexcept
 {
-    if (const auto* bval = std::get_if<bool>(&m_data); bval)
-        return std::string(*bval ? "true" : "false");
-    if (const auto* ival = std::get_if<int64_t>(&m_data); ival)
-        return std::to_string(*ival);
-    if (const auto* dval = std::get_if<double>(&m_data); dval)
-        return std::to_string(*dval) + "f";
-    if (const auto* sval = std::get_if<std::string>(&m_data); sval)
-        return "'" + *sval + "'";
+    if (isBool())
+        return std::string(getPod<bool>() ? "true" : "false");
+    if (isInt())
+        return numberToString(getPod<int64_t>());
+    if (isDouble()) {
+        std::string result;
+        appendDoubleWithPoint(result, getPod<double>());
+        result += 'f';
+        return result;
+    }
+    if (isString()) {
+        std::string result = "'";
+        result += toStringView();
+        result += '\'';
+        return result;
+    }
     return "null";
 }
 
 void PropertyTreeScalar::print(std::ostream& os, bool addQuotes, bool escapeString) const noexcept
 {
-    if (const auto* bval = std::get_if<bool>(&m_data); bval) {
-        os << (*bval ? "true" : "false");
-        return;
-    }
-    if (const auto* ival = std::get_if<int64_t>(&m_data); ival) {
-        os << *ival;
+    if (isBool()) {
+        os << (getPod<bool>() ? "true" : "false");
         return;
     }
-
-    if (const auto* dval = std::get_if<double>(&m_data); dval) {
-        os << *dval;
-        if (int(*dval) == *dval)
-            os << ".0";
+    if (isInt() || isDouble()) {
+        char buffer[s_numberBufferSize + 2];
+        os.write(buffer, (isInt() ? formatNumber(buffer, getPod<int64_t>()) : formatDoubleWithPoint(buffer, getPod<double>())) - buffer);
         return;
     }
-    if (const auto* sval = std::get_if<std::string>(&m_data); sval) {
-        printJsonString(os, *sval, addQuotes, escapeString);
+    if (isString()) {
+        printJsonString(os, toStringView(), addQuotes, escapeString);
         return;
     }
     os << "null";
@@ -130,21 +444,45 @@ void PropertyTreeScalar::print(std::ostream& os, bool addQuotes, bool escapeStri
 void PropertyTree::append(PropertyTree child) noexcept(false)
 {
     convertToList();
-    PropertyTreeList& l = getList();
-    l.push_back(std::move(child));
+    getList().push_back(std::move(child));
 }
 
 void PropertyTree::insert(const std::string& key, PropertyTree child) noexcept(false)
 {
     convertToMap();
-    PropertyTreeMap& m = getMap();
-    m[key]             = std::move(child);
+    getMap()[key] = std::move(child);
+}
+
+const PropertyTree* PropertyTree::find(std::string_view key) const noexcept
+{
+    if (!isMap())
+        return nullptr;
+    const auto& map = getMap();
+    auto        it  = map.find(key);
+    return it == map.cend() ? nullptr : &it->second;
+}
+
+const PropertyTree* PropertyTree::find(const PropertyTreeKey& key) const noexcept
+{
+    if (!isMap())
+        return nullptr;
+    const auto& map = getMap();
+    // for typical small objects linear scan is faster than binary search, and atom keys compare as pointers.
+    if (map.size() <= s_linearLookupSize) {
+        for (const auto& [childKey, child] : map) {
+            if (childKey == key)
+                return &child;
+        }
+        return nullptr;
+    }
+    auto it = map.find(key);
+    return it == map.cend() ? nullptr : &it->second;
 }
 
 void PropertyTree::convertToList() noexcept(false)
 {
     if (m_data.index() == 0)
-        m_data = PropertyTreeList{};
+        m_data = PropertyTreeList();
     if (!isList())
         throw std::runtime_error("Trying to convert varaint to list on non-empty variant");
 }
@@ -152,94 +490,272 @@ void PropertyTree::convertToList() noexcept(false)
 void PropertyTree::convertToMap() noexcept(false)
 {
     if (m_data.index() == 0)
-        m_data = PropertyTreeMap{};
+        m_data = PropertyTreeMap();
     if (!isMap())
         throw std::runtime_error("Trying to convert varaint to map on non-empty variant");
 }
 
-void PropertyTree::dump(std::ostream& stream, const DumpParams& params, int level) const noexcept
+bool PropertyTree::operator==(const PropertyTree& rh) const noexcept
 {
-    auto simplePrint = [&params, &stream](const PropertyTree& value) {
-        if (value.isNull()) {
-            stream << (params.m_isDump ? "NULL" : "null");
-            return;
+    if (isScalar() != rh.isScalar() || isList() != rh.isList() || isMap() != rh.isMap())
+        return false;
+    if (isSharedWith(rh))
+        return true;
+    const auto hash   = cachedHash();
+    const auto rhHash = rh.cachedHash();
+    if (hash && rhHash && *hash != *rhHash)
+        return false;
+    if (isScalar())
+        return getScalar() == rh.getScalar();
+    if (isList())
+        return getList() == rh.getList();
+    if (isMap())
+        return getMap() == rh.getMap();
+    return true;
+}
+
+bool PropertyTree::isSharedWith(const PropertyTree& rh) const noexcept
+{
+    if (const auto* list = std::get_if<ListPtr>(&m_data); list) {
+        const auto* rhList = std::get_if<ListPtr>(&rh.m_data);
+        return rhList && *list == *rhList;
+    }
+    if (const auto* map = std::get_if<MapPtr>(&m_data); map) {
+        const auto* rhMap = std::get_if<MapPtr>(&rh.m_data);
+        return rhMap && *map == *rhMap;
+    }
+    return false;
+}
+
+void PropertyTree::share() noexcept(false)
+{
+    // children go first, so everything reachable from a shared node is shared too and its cached hash stays valid.
+    if (auto* list = std::get_if<PropertyTreeList>(&m_data); list) {
+        for (PropertyTree& child : *list)
+            child.share();
+        m_data = makeShared(std::move(*list));
+    } else if (auto* map = std::get_if<PropertyTreeMap>(&m_data); map) {
+        for (auto& [key, child] : *map)
+            child.share();
+        m_data = makeShared(std::move(*map));
+    }
+}
+
+void PropertyTree::unshareOnCopy()
+{
+    // sharing is only safe if node lives as long as the copy: on heap or in the arena of current scope.
+    // Otherwise copy one level inline; element copies apply the same rule, so the whole subtree is copied.
+    PropertyTreeArena* current = PropertyTreeArena::current();
+    if (auto* list = std::get_if<ListPtr>(&m_data); list) {
+        PropertyTreeArena* arena = (*list)->m_value.get_allocator().getArena();
+        if (arena && arena != current) {
+            PropertyTreeList copy(std::as_const((*list)->m_value));
+            m_data = std::move(copy);
         }
-        const auto& scalar = value.getScalar();
-        if (params.m_isDump) {
-            stream << scalar.dump();
-            return;
+    } else if (auto* map = std::get_if<MapPtr>(&m_data); map) {
+        PropertyTreeArena* arena = (*map)->m_value.get_allocator().getArena();
+        if (arena && arena != current) {
+            PropertyTreeMap copy(std::as_const((*map)->m_value));
+            m_data = std::move(copy);
         }
-        scalar.print(stream, params.m_quoteValues, params.m_escapeStrings);
-    };
+    }
+}
 
-    auto checkFlatList = [&params](const PropertyTreeList& list) -> bool {
-        if (!params.m_compactArrays)
-            return false;
-        for (const auto& child : list) {
-            if (child.isList() || child.isMap()) {
-                return false;
+namespace {
+
+/// Formats PropertyTree::dump() output directly into a string.
+/// Numbers are formatted the same way as PropertyTreeScalar::print() does (shortest round-trip form).
+class ReadableWriter {
+public:
+    ReadableWriter(std::string& output, const PropertyTree::DumpParams& params, std::ostream* stream)
+        : m_output(output)
+        , m_params(params)
+        , m_stream(stream)
+    {}
+
+    // isFlat: known flatness of a list (computed by parent map), or -1.
+    void write(const PropertyTree& tree, int level, int isFlat = -1)
+    {
+        if (tree.isNull() || tree.isScalar()) {
+            pad(level);
+            writeSimple(tree);
+            return;
+        }
+        if (tree.isList()) {
+            const auto& list       = tree.getList();
+            const bool  isFlatList = isFlat >= 0 ? isFlat : checkFlatList(list);
+            pad(level);
+            m_output += isFlatList ? "[" : "[\n";
+            for (size_t index = 0, count = list.size(); index < count; ++index) {
+                write(list[index], isFlatList ? 0 : level + 1);
+                if (index < count - 1)
+                    m_output += ", ";
+                if (!isFlatList)
+                    m_output += '\n';
+                flushIfNeeded();
             }
+            if (!isFlatList)
+                pad(level);
+            m_output += ']';
+            return;
         }
-        return true;
-    };
-    auto checkFlatMap = [&checkFlatList, &params](const PropertyTreeMap& map) -> bool {
-        if (!params.m_compactMaps)
-            return false;
-        for (const auto& [key, child] : map) {
+        const auto& map = tree.getMap();
+
+        // flatness of map depends on child lists flatness, remember it so children do not check again.
+        bool isFlatMap = m_params.m_compactMaps;
+        m_childListFlat.resize(map.size());
+        for (size_t index = 0; const auto& [key, child] : map) {
+            int& childFlat = m_childListFlat[index++];
+            childFlat      = -1;
             if (child.isList()) {
-                if (child.getList().size() > params.m_smallArraySize || !checkFlatList(child.getList())) {
-                    return false;
-                }
+                childFlat = checkFlatList(child.getList());
+                if (child.getList().size() > m_params.m_smallArraySize || !childFlat)
+                    isFlatMap = false;
             }
             if (child.isMap())
+                isFlatMap = false;
+        }
+        std::vector<int> childListFlat;
+        childListFlat.swap(m_childListFlat);
+
+        pad(level);
+        m_output += isFlatMap ? "{" : "{\n";
+        for (size_t index = 0, count = map.size(); const auto& [key, child] : map) {
+            const bool simpleValue = isFlatMap || child.isNull() || child.isScalar();
+            if (!isFlatMap)
+                pad(level + 1);
+            appendString(key.view(), m_params.m_quoteKeys, m_params.m_escapeStrings);
+            m_output += simpleValue ? ": " : ": \n";
+            write(child, simpleValue ? 0 : level + 2, childListFlat[index]);
+            if (index < count - 1)
+                m_output += ", ";
+            if (!isFlatMap)
+                m_output += '\n';
+            index++;
+            flushIfNeeded();
+        }
+        if (!isFlatMap)
+            pad(level);
+        m_output += '}';
+
+        childListFlat.swap(m_childListFlat);
+    }
+
+    void flush()
+    {
+        if (!m_stream)
+            return;
+        m_stream->write(m_output.data(), m_output.size());
+        m_output.clear();
+    }
+
+private:
+    bool checkFlatList(const PropertyTreeList& list) const
+    {
+        if (!m_params.m_compactArrays)
+            return false;
+        for (const auto& child : list) {
+            if (child.isList() || child.isMap())
                 return false;
         }
         return true;
-    };
-    const std::string padBase((level) *params.m_indentWidth, ' ');
-    const std::string padNext((level + 1) * params.m_indentWidth, ' ');
+    }
 
-    if (isNull() || isScalar()) {
-        stream << padBase;
-        simplePrint(*this);
-        return;
+    void pad(int level) { m_output.append(size_t(level * m_params.m_indentWidth), ' '); }
+
+    void flushIfNeeded()
+    {
+        if (m_stream && m_output.size() >= s_flushSize)
+            flush();
     }
-    if (isList()) {
-        const bool isFlatList = checkFlatList(getList());
-        stream << padBase << '[' << (isFlatList ? "" : "\n");
-        for (size_t index = 0, count = getList().size(); const auto& child : getList()) {
-            //const bool simpleValue = isFlatList || child.isNull() || child.isScalar();
-            child.dump(stream, params, isFlatList ? 0 : level + 1);
 
-            if (index < count - 1)
-                stream << ", ";
-            if (!isFlatList)
-                stream << '\n';
-            index++;
+    void writeSimple(const PropertyTree& value)
+    {
+        if (value.isNull()) {
+            m_output += m_params.m_isDump ? "NULL" : "null";
+            return;
+        }
+        const auto& scalar = value.getScalar();
+        if (scalar.isBool()) {
+            m_output += scalar.toBool() ? "true" : "false";
+        } else if (scalar.isInt()) {
+            appendNumber(m_output, scalar.toInt());
+        } else if (scalar.isDouble()) {
+            appendDoubleWithPoint(m_output, scalar.toDouble());
+            if (m_params.m_isDump)
+                m_output += 'f';
+        } else if (scalar.isString()) {
+            if (m_params.m_isDump)
+                appendString(scalar.toStringView(), false, false, '\'');
+            else
+                appendString(scalar.toStringView(), m_params.m_quoteValues, m_params.m_escapeStrings);
+        } else {
+            m_output += "null";
         }
-        stream << (isFlatList ? "" : padBase) << ']';
-        return;
     }
-    const bool isFlatMap = checkFlatMap(getMap());
-    stream << padBase << '{' << (isFlatMap ? "" : "\n");
 
-    for (size_t index = 0, count = getMap().size(); const auto& [key, child] : getMap()) {
-        const bool simpleValue = isFlatMap || child.isNull() || child.isScalar();
-        if (!isFlatMap)
-            stream << padNext;
-        printJsonString(stream, key, params.m_quoteKeys, params.m_escapeStrings);
-        stream << ": " << (simpleValue ? "" : "\n");
-        child.dump(stream, params, simpleValue ? 0 : level + 2);
-        if (index < count - 1)
-            stream << ", ";
-        if (!isFlatMap)
-            stream << '\n';
-        index++;
+    void appendString(std::string_view value, bool addQuotes, bool escapeString, char quote = '"')
+    {
+        if (addQuotes || quote != '"')
+            m_output += quote;
+        if (escapeString) {
+            // @note: while useful for debugging pupose, pretty-print is not handling utf-8.
+            // \r\n => 0x0D 0x0A => \u000d \u000a
+            const bool escapeQuote = addQuotes && quote == '"';
+            size_t     runStart    = 0;
+            for (size_t i = 0; i < value.size(); ++i) {
+                const uint8_t byte = value[i];
+                if (byte >= 0x20 && byte != '\\' && (byte != '"' || !escapeQuote))
+                    continue;
+                m_output.append(value.data() + runStart, i - runStart);
+                runStart = i + 1;
+                if (byte == '\\') {
+                    m_output += "\\\\";
+                } else if (byte == '"') {
+                    m_output += "\\\"";
+                } else {
+                    m_output += "\\u00";
+                    m_output += toHex(byte / 16);
+                    m_output += toHex(byte % 16);
+                }
+            }
+            m_output.append(value.data() + runStart, value.size() - runStart);
+        } else {
+            m_output += value;
+        }
+        if (addQuotes || quote != '"')
+            m_output += quote;
     }
-    stream << (isFlatMap ? "" : padBase) << '}';
+
+    static constexpr size_t s_flushSize = 64 * 1024;
+
+    std::string&                    m_output;
+    const PropertyTree::DumpParams& m_params;
+    std::ostream* const             m_stream;
+    std::vector<int>                m_childListFlat;
+};
+
 }
 
-void PropertyTree::mergePatch(PropertyTree& dest, const PropertyTree& source) noexcept(false)
+void PropertyTree::dump(std::ostream& stream, const DumpParams& params, int level) const noexcept
+{
+    std::string    buffer;
+    ReadableWriter writer(buffer, params, &stream);
+    writer.write(*this, level);
+    writer.flush();
+}
+
+void PropertyTree::dump(std::string& buffer, const DumpParams& params, int level) const noexcept(false)
+{
+    ReadableWriter writer(buffer, params, nullptr);
+    writer.write(*this, level);
+}
+
+namespace {
+
+// Source is either const PropertyTree& (values are copied) or PropertyTree (rvalue, values are moved).
+template<class Source>
+void mergePatchImpl(PropertyTree& dest, Source&& source)
 {
     // https://tools.ietf.org/html/rfc7396
     //	define MergePatch(Target, Patch):
@@ -255,90 +771,210 @@ void PropertyTree::mergePatch(PropertyTree& dest, const PropertyTree& source) no
     //		return Target
     //	  else:
     //		return Patch
+    constexpr bool canMove = !std::is_lvalue_reference_v<Source>;
     if (!source.isMap()) {
-        dest = source;
+        if constexpr (canMove)
+            dest = std::move(source);
+        else
+            dest = source;
         return;
     }
-    if (dest.isNull())
-        dest.convertToMap();
+    if (!dest.isMap())
+        dest = PropertyTree(PropertyTreeMap{});
+
+    // both maps are sorted, so existing keys are found in a single pass; a small patch into a large map looks each key up
+    // with binary search instead. New keys are collected aside and added at the end, so iterators into dest stay valid.
+    // Erase from a sorted vector shifts its tail, so there removed keys are erased at once; node map erases in place.
+    constexpr bool    contiguous = std::random_access_iterator<PropertyTreeMap::iterator>;
+    auto&&            sourceMap  = source.getMap();
+    auto&             destMap    = dest.getMap();
+    const bool        lookup     = sourceMap.size() * std::bit_width(destMap.size()) < destMap.size();
+    PropertyTreeMap   added;
+    std::vector<bool> removed;
+    auto              destIt = destMap.begin();
+    for (auto&& [key, value] : sourceMap) {
+        if (lookup)
+            destIt = destMap.lower_bound(key);
+        else
+            while (destIt != destMap.end() && destIt->first < key)
+                ++destIt;
+        const bool exists = destIt != destMap.end() && destIt->first == key;
 
-    if (!dest.isMap()) {
-        dest = {};
-        return;
-    }
-    auto& destMap = dest.getMap();
-    for (const auto& [key, value] : source.getMap()) {
-        // if Value is null:
-        //   if Name exists in Target:
-        //     remove the Name/Value pair from Target
-        //   else:
-        //     Target[Name] = MergePatch(Target[Name], Value)
-        if (value.isNull())
-            destMap.erase(key);
+        if (value.isNull()) {
+            if (!exists)
+                continue;
+            if constexpr (contiguous) {
+                removed.resize(destMap.size());
+                removed[std::distance(destMap.begin(), destIt)] = true;
+            } else {
+                destIt = destMap.erase(destIt);
+            }
+            continue;
+        }
+
+        PropertyTree* target = nullptr;
+        if (exists) {
+            target = &destIt->second;
+        } else {
+            if constexpr (canMove)
+                target = &added.appendUnsorted(std::move(key));
+            else
+                target = &added.appendUnsorted(key);
+        }
+        if constexpr (canMove)
+            mergePatchImpl(*target, std::move(value));
         else
-            mergePatch(destMap[key], value);
+            mergePatchImpl(*target, value);
     }
+    if (!removed.empty())
+        eraseMarked(destMap, removed);
+    if (added.empty())
+        return;
+    for (auto&& [key, value] : added)
+        destMap.appendUnsorted(std::move(key)) = std::move(value);
+    destMap.sortAppended();
 }
 
-void PropertyTree::removeEqualValues(PropertyTree& one, PropertyTree& two) noexcept(false)
+void diffImpl(const PropertyTree& from, const PropertyTree& to, PropertyTree& patch)
 {
-    if (one == two) {
-        one = {};
-        two = {};
+    if (!from.isMap() || !to.isMap()) {
+        patch = to;
         return;
     }
-
-    if (one.isMap()) {
-        if (!two.isMap())
-            return;
-        auto& oneMap = one.getMap();
-        auto& twoMap = two.getMap();
-
-        std::vector<std::string> commonKeys;
-        for (auto&& [key, value] : oneMap) {
-            if (!twoMap.contains(key))
-                continue;
-            commonKeys.push_back(key);
+    auto&           fromMap = from.getMap();
+    auto&           toMap   = to.getMap();
+    PropertyTreeMap result;
+
+    // keys are visited in sorted order, so result is built without sorting.
+    auto fromIt = fromMap.begin();
+    auto toIt   = toMap.begin();
+    while (fromIt != fromMap.end() || toIt != toMap.end()) {
+        if (toIt == toMap.end() || (fromIt != fromMap.end() && fromIt->first < toIt->first)) {
+            // removed key.
+            result.appendUnsorted(fromIt->first);
+            ++fromIt;
+            continue;
         }
-        for (const auto& key : commonKeys) {
-            auto& oneMapValue = oneMap[key];
-            auto& twoMapValue = twoMap[key];
-            removeEqualValues(oneMapValue, twoMapValue);
-            if (oneMapValue.isNull() && twoMapValue.isNull()) {
-                oneMap.erase(key);
-                twoMap.erase(key);
-            }
+        if (fromIt == fromMap.end() || toIt->first < fromIt->first) {
+            // added key; null value is the same as absent key.
+            if (!toIt->second.isNull())
+                result.appendUnsorted(toIt->first) = toIt->second;
+            ++toIt;
+            continue;
         }
+        const PropertyTree& fromValue = fromIt->second;
+        const PropertyTree& toValue   = toIt->second;
+        if (toValue.isNull()) {
+            if (!fromValue.isNull())
+                result.appendUnsorted(toIt->first);
+        } else if (fromValue.isMap() && toValue.isMap()) {
+            PropertyTree childPatch;
+            diffImpl(fromValue, toValue, childPatch);
+            if (!std::as_const(childPatch).getMap().empty())
+                result.appendUnsorted(toIt->first) = std::move(childPatch);
+        } else if (!(fromValue == toValue)) {
+            result.appendUnsorted(toIt->first) = toValue;
+        }
+        ++fromIt;
+        ++toIt;
     }
-    if (one.isList()) {
-        if (!two.isList())
-            return;
+    result.sortAppended();
+    patch = PropertyTree(std::move(result));
+}
 
-        auto& oneList = one.getList();
-        auto& twoList = two.getList();
+}
 
-        const auto minSize = std::min(oneList.size(), twoList.size());
-        for (size_t i = 0; i < minSize; ++i) {
-            auto& oneListValue = oneList[i];
-            auto& twoListValue = twoList[i];
-            removeEqualValues(oneListValue, twoListValue);
-        }
+void PropertyTree::mergePatch(PropertyTree& dest, const PropertyTree& source) noexcept(false)
+{
+    mergePatchImpl(dest, source);
+}
+
+void PropertyTree::mergePatch(PropertyTree& dest, PropertyTree&& source) noexcept(false)
+{
+    mergePatchImpl(dest, std::move(source));
+}
+
+PropertyTree PropertyTree::diff(const PropertyTree& from, const PropertyTree& to) noexcept(false)
+{
+    PropertyTree patch;
+    diffImpl(from, to, patch);
+    return patch;
+}
+
+void PropertyTree::removeEqualValues(PropertyTree& one, PropertyTree& two) noexcept(false)
+{
+    removeEqualValuesImpl(one, two);
+}
+
+uint64_t PropertyTree::hash() const noexcept
+{
+    if (const auto* list = std::get_if<ListPtr>(&m_data))
+        return nodeHash(**list);
+    if (const auto* map = std::get_if<MapPtr>(&m_data))
+        return nodeHash(**map);
+    Hasher hasher;
+    if (const auto* list = std::get_if<PropertyTreeList>(&m_data))
+        hasher.updateContainer(*list);
+    else if (const auto* map = std::get_if<PropertyTreeMap>(&m_data))
+        hasher.updateContainer(*map);
+    else
+        hasher.updateTree(*this);
+    return hasher.digest();
+}
+
+std::optional<uint64_t> PropertyTree::cachedHash() const noexcept
+{
+    const std::atomic<uint64_t>* hash  = nullptr;
+    const std::atomic<bool>*     valid = nullptr;
+    if (const auto* list = std::get_if<ListPtr>(&m_data)) {
+        hash  = &(*list)->m_hash;
+        valid = &(*list)->m_hashValid;
+    } else if (const auto* map = std::get_if<MapPtr>(&m_data)) {
+        hash  = &(*map)->m_hash;
+        valid = &(*map)->m_hashValid;
     }
+    if (!valid || !valid->load(std::memory_order_acquire))
+        return std::nullopt;
+    return hash->load(std::memory_order_relaxed);
+}
+
+template<class T>
+uint64_t PropertyTree::nodeHash(const Shared<T>& node) noexcept
+{
+    // node is immutable, so computed hash never gets stale. Concurrent first calls store the same value.
+    if (node.m_hashValid.load(std::memory_order_acquire))
+        return node.m_hash.load(std::memory_order_relaxed);
+
+    Hasher hasher;
+    hasher.updateContainer(node.m_value);
+    const uint64_t result = hasher.digest();
+    node.m_hash.store(result, std::memory_order_relaxed);
+    node.m_hashValid.store(true, std::memory_order_release);
+    return result;
+}
+
+namespace {
+constexpr PropertyTree::DumpParams s_readableJsonParams{
+    .m_indentWidth   = 4,
+    .m_isDump        = false,
+    .m_quoteKeys     = true,
+    .m_quoteValues   = true,
+    .m_escapeStrings = true,
+};
 }
 
 void PropertyTree::printReadableJson(std::ostream& stream, const PropertyTree& source) noexcept
 {
-    source.dump(stream, DumpParams{
-                            .m_indentWidth   = 4,
-                            .m_isDump        = false,
-                            .m_quoteKeys     = true,
-                            .m_quoteValues   = true,
-                            .m_escapeStrings = true,
-                        },
-                0);
+    source.dump(stream, s_readableJsonParams, 0);
     stream << '\n';
 }
 
+void PropertyTree::printReadableJson(std::string& buffer, const PropertyTree& source) noexcept(false)
+{
+    source.dump(buffer, s_readableJsonParams, 0);
+    buffer += '\n';
+}
+
 std::ostream& operator<<(std::ostream& stream, const PropertyTree& tree)
 {
     tree.dump(stream, PropertyTree::DumpParams{}, 0);
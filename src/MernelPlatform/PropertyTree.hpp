@@ -6,12 +6,23 @@
 #pragma once
 
 #include "MernelPlatformExport.hpp"
+#include "FlatMap.hpp"
+#include "PropertyTreeArena.hpp"
+#include "PropertyTreeKey.hpp"
+#include "StableMap.hpp"
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <iosfwd>
 #include <map>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -25,39 +36,69 @@ concept PropertyTreeFloating = std::is_floating_point_v<T>;
 template<class T>
 concept PropertyTreeScalarHeld = PropertyTreeIntegral<T> || PropertyTreeFloating<T> || std::is_same_v<T, std::string>;
 
+/**
+ * @brief Scalar value of PropertyTree: null, bool, integer, double or string.
+ *
+ * Scalar takes 16 bytes. Strings up to 13 characters are stored inline, longer strings are allocated on heap.
+ * String may also be borrowed from immutable external memory (see borrowed()), then scalar does not own it.
+ * Copy of borrowed scalar makes its own string, move keeps it borrowed - same as PropertyTreeArena containers.
+ */
 class MERNELPLATFORM_EXPORT PropertyTreeScalar {
 public:
-    PropertyTreeScalar()                                     = default;
-    PropertyTreeScalar(const PropertyTreeScalar&)            = default;
-    PropertyTreeScalar& operator=(const PropertyTreeScalar&) = default;
+    PropertyTreeScalar() noexcept = default;
+    PropertyTreeScalar(const PropertyTreeScalar& rh) { copyFrom(rh); }
+    PropertyTreeScalar& operator=(const PropertyTreeScalar& rh)
+    {
+        if (this != &rh) {
+            reset();
+            copyFrom(rh);
+        }
+        return *this;
+    }
 
-    PropertyTreeScalar(PropertyTreeScalar&&) noexcept               = default;
-    PropertyTreeScalar& operator=(PropertyTreeScalar&& rh) noexcept = default;
+    PropertyTreeScalar(PropertyTreeScalar&& rh) noexcept { moveFrom(rh); }
+    PropertyTreeScalar& operator=(PropertyTreeScalar&& rh) noexcept
+    {
+        if (this != &rh) {
+            reset();
+            moveFrom(rh);
+        }
+        return *this;
+    }
+    ~PropertyTreeScalar() { reset(); }
 
-    explicit PropertyTreeScalar(PropertyTreeIntegral auto value)
-        : m_data(static_cast<int64_t>(value))
-    {}
-    explicit PropertyTreeScalar(PropertyTreeFloating auto value)
-        : m_data(static_cast<double>(value))
-    {}
-    explicit PropertyTreeScalar(bool value)
-        : m_data(value)
-    {}
-    explicit PropertyTreeScalar(std::string value)
-        : m_data(std::move(value))
-    {}
-    explicit PropertyTreeScalar(const char* value)
-        : m_data(std::string(value))
-    {}
+    explicit PropertyTreeScalar(PropertyTreeIntegral auto value) noexcept
+    {
+        setPod(Type::Int, static_cast<int64_t>(value));
+    }
+    explicit PropertyTreeScalar(PropertyTreeFloating auto value) noexcept
+    {
+        setPod(Type::Double, static_cast<double>(value));
+    }
+    explicit PropertyTreeScalar(bool value) noexcept
+    {
+        setPod(Type::Bool, value);
+    }
+    explicit PropertyTreeScalar(const std::string& value) { setString(value); }
+    explicit PropertyTreeScalar(std::string_view value) { setString(value); }
+    explicit PropertyTreeScalar(const char* value) { setString(value); }
+
+    /// Makes scalar referencing external string without copy. Memory must be immutable, outlive the scalar and all its moved instances,
+    /// and have '\0' right after the view (toCString() returns pointer to it). Typical source is a buffer stored in PropertyTreeArena.
+    [[nodiscard]] static PropertyTreeScalar borrowed(std::string_view value) noexcept(false);
 
-    bool operator==(const PropertyTreeScalar& rh) const noexcept = default;
+    bool operator==(const PropertyTreeScalar& rh) const noexcept;
+
+    /// 64-bit hash consistent with operator==.
+    uint64_t hash() const noexcept;
 
     // convert value to standard scalar types. If conversion cannot be made, returns default value.
-    bool               toBool() const noexcept;
-    const std::string& toString() const noexcept;
-    const char*        toCString() const noexcept;
-    int64_t            toInt() const noexcept;
-    double             toDouble() const noexcept;
+    bool             toBool() const noexcept;
+    std::string      toString() const noexcept(false);
+    std::string_view toStringView() const noexcept;
+    const char*      toCString() const noexcept;
+    int64_t          toInt() const noexcept;
+    double           toDouble() const noexcept;
 
     template<PropertyTreeIntegral T>
     void convertTo(T& value) const noexcept
@@ -70,36 +111,115 @@ public:
     {
         value = static_cast<T>(toDouble());
     }
-    void convertTo(std::string& value) const noexcept { value = toString(); }
+    void convertTo(std::string& value) const noexcept(false) { value.assign(toStringView()); }
 
     // print any possible value as a string.
     [[nodiscard]] std::string dump() const noexcept;
     void                      print(std::ostream& os, bool addQuotes = true, bool escapeString = true) const noexcept;
 
-    [[nodiscard]] bool isNull() const noexcept { return m_data.index() == 0; }
-    [[nodiscard]] bool isBool() const noexcept { return m_data.index() == 1; }
-    [[nodiscard]] bool isInt() const noexcept { return m_data.index() == 2; }
-    [[nodiscard]] bool isDouble() const noexcept { return m_data.index() == 3; }
-    [[nodiscard]] bool isString() const noexcept { return m_data.index() == 4; }
+    [[nodiscard]] bool isNull() const noexcept { return m_type == Type::Null; }
+    [[nodiscard]] bool isBool() const noexcept { return m_type == Type::Bool; }
+    [[nodiscard]] bool isInt() const noexcept { return m_type == Type::Int; }
+    [[nodiscard]] bool isDouble() const noexcept { return m_type == Type::Double; }
+    [[nodiscard]] bool isString() const noexcept { return m_type >= Type::StringInline; }
+    [[nodiscard]] bool isBorrowed() const noexcept { return m_type == Type::StringBorrowed; }
 
 private:
-    std::variant<std::monostate, bool, int64_t, double, std::string> m_data;
+    enum class Type : uint8_t
+    {
+        Null,
+        Bool,
+        Int,
+        Double,
+        StringInline,
+        StringHeap,
+        StringBorrowed,
+    };
+    static constexpr size_t s_inlineCapacity = 13;
+
+    template<class T>
+    void setPod(Type type, T value) noexcept
+    {
+        std::memcpy(m_storage, &value, sizeof(T));
+        m_type = type;
+    }
+    template<class T>
+    T getPod() const noexcept
+    {
+        T value;
+        std::memcpy(&value, m_storage, sizeof(T));
+        return value;
+    }
+
+    void setString(std::string_view value) noexcept(false);
+    void setExternal(Type type, const char* data, size_t size) noexcept;
+    void copyFrom(const PropertyTreeScalar& rh) noexcept(false);
+    void moveFrom(PropertyTreeScalar& rh) noexcept;
+    void reset() noexcept;
+
+private:
+    // bool, int64 or double value; or pointer and 32-bit size of external string; or inline string with terminating zero.
+    alignas(8) char m_storage[s_inlineCapacity + 1]{};
+    uint8_t         m_inlineSize = 0;
+    Type            m_type       = Type::Null;
 };
+static_assert(sizeof(PropertyTreeScalar) == 16);
 
 class PropertyTree;
 
-using PropertyTreeList      = std::vector<PropertyTree>;
-using PropertyTreeMap       = std::map<std::string, PropertyTree>;
+// containers use PropertyTreeAllocator, so the whole document can be placed in PropertyTreeArena.
+// Map is std::map based (StableMap) by default: inserting or erasing keeps references to other elements valid.
+// With MERNEL_PROPERTY_TREE_FLAT_MAP (CMake option of the same name) map is a sorted vector (FlatMap) instead: iteration and
+// lookup are more cache-friendly, but any insertion or erase invalidates references and iterators to its elements,
+// e.g. `auto& a = tree["a"]; tree["b"] = x;` leaves `a` dangling. Iteration order and interface are the same.
+using PropertyTreeList = std::vector<PropertyTree, PropertyTreeAllocator<PropertyTree>>;
+#ifdef MERNEL_PROPERTY_TREE_FLAT_MAP
+using PropertyTreeMap = FlatMap<PropertyTreeKey, PropertyTree, std::less<>, PropertyTreeAllocator<std::pair<PropertyTreeKey, PropertyTree>>>;
+#else
+using PropertyTreeMap = StableMap<PropertyTreeKey, PropertyTree, std::less<>, PropertyTreeAllocator<std::pair<const PropertyTreeKey, PropertyTree>>>;
+#endif
 using PropertyTreeScalarMap = std::map<std::string, PropertyTreeScalar>;
 
+/**
+ * @brief JSON-like value: null, scalar, list or map.
+ *
+ * Lists and maps are held inline and copied deeply. share() moves them into immutable reference-counted nodes, then copying
+ * the tree is O(1). Non-const access to a shared container (getList(), getMap(), operator[], append() etc) takes one level
+ * out of its node first: moves it if this tree is the only owner, clones it otherwise (children stay shared). So a reference
+ * from non-const accessor always points to a container owned by this tree alone, and copies made later do not see writes to it.
+ * Shared nodes placed in PropertyTreeArena are shared only inside the same arena scope; copy made outside of it is deep.
+ * Moved-from tree is null.
+ */
 class MERNELPLATFORM_EXPORT PropertyTree {
 public:
-    PropertyTree()                               = default;
-    PropertyTree(const PropertyTree&)            = default;
-    PropertyTree& operator=(const PropertyTree&) = default;
+    PropertyTree() = default;
+    PropertyTree(const PropertyTree& rh)
+        : m_data(rh.m_data)
+    {
+        unshareOnCopy();
+    }
+    PropertyTree& operator=(const PropertyTree& rh)
+    {
+        if (this != &rh) {
+            m_data = rh.m_data;
+            unshareOnCopy();
+        }
+        return *this;
+    }
 
-    PropertyTree(PropertyTree&&) noexcept               = default;
-    PropertyTree& operator=(PropertyTree&& rh) noexcept = default;
+    PropertyTree(PropertyTree&& rh) noexcept
+        : m_data(std::move(rh.m_data))
+    {
+        rh.m_data = std::monostate{};
+    }
+    PropertyTree& operator=(PropertyTree&& rh) noexcept
+    {
+        if (this != &rh) {
+            m_data    = std::move(rh.m_data);
+            rh.m_data = std::monostate{};
+        }
+        return *this;
+    }
 
     // making this explicit will be very inconvenient.
     PropertyTree(PropertyTreeScalar scalar)
@@ -108,19 +228,25 @@ public:
     explicit PropertyTree(const PropertyTreeScalarMap& scmap)
     {
         PropertyTreeMap copy;
+        copy.reserve(scmap.size());
         for (const auto& p : scmap)
-            copy[p.first] = p.second;
+            copy.appendUnsorted(p.first) = p.second;
         m_data = std::move(copy);
     }
     explicit PropertyTree(PropertyTreeMap tmap)
         : m_data(std::move(tmap))
     {}
+    explicit PropertyTree(PropertyTreeList tlist)
+        : m_data(std::move(tlist))
+    {}
 
     // check what is inside
     [[nodiscard]] bool isNull() const noexcept { return m_data.index() == 0; }
     [[nodiscard]] bool isScalar() const noexcept { return m_data.index() == 1; }
-    [[nodiscard]] bool isList() const noexcept { return m_data.index() == 2; }
-    [[nodiscard]] bool isMap() const noexcept { return m_data.index() == 3; }
+    [[nodiscard]] bool isList() const noexcept { return m_data.index() == 2 || m_data.index() == 4; }
+    [[nodiscard]] bool isMap() const noexcept { return m_data.index() == 3 || m_data.index() == 5; }
+    // true if list or map is held in a shared node (see share()).
+    [[nodiscard]] bool isShared() const noexcept { return m_data.index() >= 4; }
 
     // const access to scalar and containers. May throw.
     const auto& getScalar() const noexcept(false)
@@ -133,16 +259,20 @@ public:
     {
         if (const auto* val = std::get_if<PropertyTreeList>(&m_data); val)
             return *val;
+        if (const auto* val = std::get_if<ListPtr>(&m_data); val)
+            return std::as_const((*val)->m_value);
         throw std::runtime_error("Invalid variant access, list expected");
     }
     const auto& getMap() const noexcept(false)
     {
         if (const auto* val = std::get_if<PropertyTreeMap>(&m_data); val)
             return *val;
+        if (const auto* val = std::get_if<MapPtr>(&m_data); val)
+            return std::as_const((*val)->m_value);
         throw std::runtime_error("Invalid variant access, map expected");
     }
 
-    // non-const access. May throw.
+    // non-const access. May throw. Shared container is taken out of its node first.
     auto& getScalar() noexcept(false)
     {
         if (auto* val = std::get_if<PropertyTreeScalar>(&m_data); val)
@@ -153,43 +283,77 @@ public:
     {
         if (auto* val = std::get_if<PropertyTreeList>(&m_data); val)
             return *val;
+        if (std::holds_alternative<ListPtr>(m_data))
+            return unshare<PropertyTreeList>();
         throw std::runtime_error("Invalid variant access, list expected");
     }
     auto& getMap() noexcept(false)
     {
         if (auto* val = std::get_if<PropertyTreeMap>(&m_data); val)
             return *val;
+        if (std::holds_alternative<MapPtr>(m_data))
+            return unshare<PropertyTreeMap>();
         throw std::runtime_error("Invalid variant access, map expected");
     }
 
     // checks if container has child object with provided key. returns false if property is not a map.
-    bool contains(const std::string& key) const noexcept
-    {
-        if (!isMap())
-            return false;
-        return getMap().contains(key);
-    }
+    bool contains(const std::string& key) const noexcept { return find(key) != nullptr; }
+    bool contains(const PropertyTreeKey& key) const noexcept { return find(key) != nullptr; }
+
+    // returns child object with provided key, or nullptr if there is no such key or property is not a map.
+    // lookup by atom key in a small map compares only pointers.
+    const PropertyTree* find(std::string_view key) const noexcept;
+    const PropertyTree* find(const PropertyTreeKey& key) const noexcept;
 
     // get direct access to child value by key. Will throw if no key exists or variant is not a map.
-    const PropertyTree& operator[](const std::string& key) const noexcept(false) { return getMap().at(key); }
+    const PropertyTree& operator[](const std::string& key) const noexcept(false)
+    {
+        if (const auto* child = find(key))
+            return *child;
+        throw std::out_of_range("PropertyTree: key not found");
+    }
+    const PropertyTree& operator[](const PropertyTreeKey& key) const noexcept(false)
+    {
+        if (const auto* child = find(key))
+            return *child;
+        throw std::out_of_range("PropertyTree: key not found");
+    }
     // add new key into map or modify existing one. property will be automatically converted to map type.
     PropertyTree& operator[](const std::string& key) noexcept(false)
     {
-        if (m_data.index() == 0)
-            m_data = PropertyTreeMap{};
+        convertToMap();
+        return getMap()[key];
+    }
+    PropertyTree& operator[](const PropertyTreeKey& key) noexcept(false)
+    {
+        convertToMap();
         return getMap()[key];
     }
     PropertyTreeScalar value(const std::string& key, PropertyTreeScalar defaultValue) const noexcept(false)
     {
-        if (!isMap())
-            return defaultValue;
-        const auto& map = getMap();
-        auto        it  = map.find(key);
-        if (it == map.cend())
-            return defaultValue;
-        return it->second.getScalar();
+        const auto* child = find(key);
+        return child ? child->getScalar() : defaultValue;
+    }
+    PropertyTreeScalar value(const PropertyTreeKey& key, PropertyTreeScalar defaultValue) const noexcept(false)
+    {
+        const auto* child = find(key);
+        return child ? child->getScalar() : defaultValue;
     }
-    bool operator==(const PropertyTree& rh) const noexcept = default;
+    // shared nodes are compared by pointer first, and are unequal without traversal if their cached hashes differ.
+    bool operator==(const PropertyTree& rh) const noexcept;
+
+    /// Moves lists and maps of the whole subtree into shared nodes, so copies of it are O(1). Already shared nodes are kept,
+    /// so after a few edits only the modified path is moved again.
+    void share() noexcept(false);
+
+    // true if both trees share the same list or map node (after share() and copy, without modification).
+    [[nodiscard]] bool isSharedWith(const PropertyTree& rh) const noexcept;
+
+    /// Structural 64-bit hash of the whole subtree: equal trees have equal hashes.
+    /// Shared nodes are immutable, so their hash is computed once and cached; inline containers are hashed on every call.
+    uint64_t hash() const noexcept;
+    /// Hash of shared node if it was computed already, without computing it.
+    [[nodiscard]] std::optional<uint64_t> cachedHash() const noexcept;
 
     void append(PropertyTree child) noexcept(false);
     void insert(const std::string& key, PropertyTree child) noexcept(false);
@@ -212,19 +376,78 @@ public:
     };
 
     void dump(std::ostream& stream, const DumpParams& params, int level = 0) const noexcept;
+    void dump(std::string& buffer, const DumpParams& params, int level = 0) const noexcept(false);
 
 public:
+    // apply RFC 7396 merge patch. Rvalue overload moves values out of the patch instead of copying them.
     static void mergePatch(PropertyTree& dest, const PropertyTree& source) noexcept(false);
+    static void mergePatch(PropertyTree& dest, PropertyTree&& source) noexcept(false);
+    // make minimal merge patch, so mergePatch(from, diff(from, to)) gives `to`. Only changed values are copied.
+    // Merge patch can not express null as a map value, such values in `to` are treated as absent keys.
+    [[nodiscard]] static PropertyTree diff(const PropertyTree& from, const PropertyTree& to) noexcept(false);
+    // removes values present in both trees; equal subtrees become null. Single pass over both trees.
     static void removeEqualValues(PropertyTree& one, PropertyTree& two) noexcept(false);
 
     // that function is not utf-safe! Only for debugging purpose (or if you sure that no Unicode string exist)
     static void printReadableJson(std::ostream& stream, const PropertyTree& source) noexcept;
+    static void printReadableJson(std::string& buffer, const PropertyTree& source) noexcept(false);
 
     MERNELPLATFORM_EXPORT friend std::ostream& operator<<(std::ostream& stream, const PropertyTree& tree);
 
 private:
-    using Variant = std::variant<std::monostate, PropertyTreeScalar, PropertyTreeList, PropertyTreeMap>;
+    template<class T>
+    struct Shared {
+        template<class... Args>
+        explicit Shared(Args&&... args)
+            : m_value(std::forward<Args>(args)...)
+        {}
+
+        T m_value; // never modified while shared; the only owner moves it out.
+
+        mutable std::atomic<uint64_t> m_hash{ 0 };
+        mutable std::atomic<bool>     m_hashValid{ false };
+    };
+
+    using ListPtr = std::shared_ptr<Shared<PropertyTreeList>>;
+    using MapPtr  = std::shared_ptr<Shared<PropertyTreeMap>>;
+    using Variant = std::variant<std::monostate, PropertyTreeScalar, PropertyTreeList, PropertyTreeMap, ListPtr, MapPtr>;
+
+    // node and its control block are allocated in the arena of the container, so they have the same lifetime.
+    template<class T>
+    static std::shared_ptr<Shared<T>> makeShared(T value)
+    {
+        const PropertyTreeAllocator<Shared<T>> allocator(value.get_allocator());
+        return std::allocate_shared<Shared<T>>(allocator, std::move(value));
+    }
+    // replaces shared node with inline container: moved out if this tree is the only owner, one level cloned otherwise.
+    template<class T>
+    T& unshare()
+    {
+        auto& node = std::get<std::shared_ptr<Shared<T>>>(m_data);
+        if (node.use_count() == 1) {
+            // use_count() is a relaxed load: synchronize with the release decrements of former owners before writing.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            T value(std::move(node->m_value));
+            return m_data.template emplace<T>(std::move(value));
+        }
+        T value(std::as_const(node->m_value));
+        return m_data.template emplace<T>(std::move(value));
+    }
+    template<class T>
+    static uint64_t nodeHash(const Shared<T>& node) noexcept;
+    // shared node placed in arena of another scope is copied to inline container (deep copy).
+    void unshareOnCopy();
+
     Variant m_data;
 };
 
 }
+
+template<>
+struct std::hash<Mernel::PropertyTreeScalar> {
+    size_t operator()(const Mernel::PropertyTreeScalar& value) const noexcept { return static_cast<size_t>(value.hash()); }
+};
+template<>
+struct std::hash<Mernel::PropertyTree> {
+    size_t operator()(const Mernel::PropertyTree& value) const noexcept { return static_cast<size_t>(value.hash()); }
+};
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "PropertyTreeArena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+namespace Mernel {
+
+namespace {
+thread_local PropertyTreeArena* t_currentArena = nullptr;
+
+constexpr size_t s_maxBlockSize = 16 * 1024 * 1024;
+}
+
+struct PropertyTreeArena::Block {
+    Block* m_next = nullptr;
+    size_t m_size = 0;
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+};
+
+PropertyTreeArena::PropertyTreeArena(size_t blockSize)
+    : m_blockSize(blockSize)
+{
+    assert(blockSize > 0);
+}
+
+PropertyTreeArena::~PropertyTreeArena()
+{
+    assert(t_currentArena != this);
+    while (m_head) {
+        Block* next = m_head->m_next;
+        ::operator delete(m_head);
+        m_head = next;
+    }
+}
+
+void* PropertyTreeArena::allocate(size_t bytes, size_t alignment)
+{
+    auto alignUp = [alignment](char* p) {
+        const auto addr = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((addr + alignment - 1) & ~uintptr_t(alignment - 1));
+    };
+
+    char* result = m_pos ? alignUp(m_pos) : nullptr;
+    if (!result || result + bytes > m_end) {
+        // every block is twice as large as previous one, so amount of blocks is logarithmic from document size.
+        const size_t size = std::max(m_blockSize, bytes + alignment + sizeof(Block));
+
+        Block* block  = static_cast<Block*>(::operator new(size));
+        block->m_next = m_head;
+        block->m_size = size;
+        m_head        = block;
+        m_pos         = block->data();
+        m_end         = reinterpret_cast<char*>(block) + size;
+        m_reservedBytes += size;
+        if (m_blockSize < s_maxBlockSize)
+            m_blockSize *= 2;
+
+        result = alignUp(m_pos);
+    }
+    m_pos = result + bytes;
+    m_usedBytes += bytes;
+    return result;
+}
+
+PropertyTreeArena* PropertyTreeArena::current() noexcept
+{
+    return t_currentArena;
+}
+
+PropertyTreeArena::Scope::Scope(PropertyTreeArena& arena) noexcept
+    : m_prev(t_currentArena)
+{
+    t_currentArena = &arena;
+}
+
+PropertyTreeArena::Scope::~Scope()
+{
+    t_currentArena = m_prev;
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "MernelPlatformExport.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace Mernel {
+
+/**
+ * @brief Monotonic memory arena for PropertyTree documents.
+ *
+ * While PropertyTreeArena::Scope is alive on current thread, every list and map created by PropertyTree takes memory from the arena.
+ * Deallocation of arena memory is no-op; everything is released at once when arena is destroyed.
+ *
+ * General usage:
+ *
+ * PropertyTreeArena arena;
+ * PropertyTree      tree;
+ * {
+ *     PropertyTreeArena::Scope scope(arena);
+ *     tree = readJsonFromBuffer(buffer);
+ * }
+ *
+ * Important: tree must be destroyed before the arena. Moved containers keep their memory,
+ * so if subtree should outlive the arena, make a copy of it outside of the scope.
+ */
+class MERNELPLATFORM_EXPORT PropertyTreeArena {
+public:
+    explicit PropertyTreeArena(size_t blockSize = 64 * 1024);
+    ~PropertyTreeArena();
+
+    [[nodiscard]] void* allocate(size_t bytes, size_t alignment);
+
+    /// Total bytes handed out by allocate() and total bytes reserved in blocks.
+    size_t getUsedBytes() const noexcept { return m_usedBytes; }
+    size_t getReservedBytes() const noexcept { return m_reservedBytes; }
+
+    /// Arena active on current thread, or nullptr if PropertyTree uses global heap.
+    static PropertyTreeArena* current() noexcept;
+
+    class MERNELPLATFORM_EXPORT Scope {
+    public:
+        explicit Scope(PropertyTreeArena& arena) noexcept;
+        ~Scope();
+
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        PropertyTreeArena* m_prev = nullptr;
+    };
+
+private:
+    PropertyTreeArena(const PropertyTreeArena&)            = delete;
+    PropertyTreeArena& operator=(const PropertyTreeArena&) = delete;
+
+    struct Block;
+
+    Block* m_head          = nullptr;
+    char*  m_pos           = nullptr;
+    char*  m_end           = nullptr;
+    size_t m_blockSize     = 0;
+    size_t m_usedBytes     = 0;
+    size_t m_reservedBytes = 0;
+};
+
+/// Allocator used by PropertyTree containers. Binds to the arena that was current at construction time (or heap, if none).
+/// Copied containers are allocated in the arena current at copy time; moved containers keep their memory.
+template<class T>
+class PropertyTreeAllocator {
+public:
+    using value_type = T;
+
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::false_type;
+
+    PropertyTreeAllocator() noexcept
+        : m_arena(PropertyTreeArena::current())
+    {}
+    template<class U>
+    PropertyTreeAllocator(const PropertyTreeAllocator<U>& other) noexcept
+        : m_arena(other.getArena())
+    {}
+
+    [[nodiscard]] T* allocate(size_t n)
+    {
+        if (m_arena)
+            return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) noexcept
+    {
+        if (!m_arena)
+            std::allocator<T>().deallocate(p, n);
+    }
+
+    PropertyTreeAllocator select_on_container_copy_construction() const noexcept { return PropertyTreeAllocator(); }
+
+    PropertyTreeArena* getArena() const noexcept { return m_arena; }
+
+    template<class U>
+    bool operator==(const PropertyTreeAllocator<U>& rh) const noexcept
+    {
+        return m_arena == rh.getArena();
+    }
+
+private:
+    PropertyTreeArena* m_arena = nullptr;
+};
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "PropertyTreeKey.hpp"
+
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace Mernel {
+
+namespace {
+
+class AtomTable {
+public:
+    const std::string* intern(std::string_view str)
+    {
+        {
+            std::shared_lock lock(m_mutex);
+            if (auto it = m_index.find(str); it != m_index.cend())
+                return it->second;
+        }
+        std::unique_lock lock(m_mutex);
+        if (auto it = m_index.find(str); it != m_index.cend())
+            return it->second;
+
+        // deque never relocates elements, so both the pointer and the view used as index key stay valid.
+        const std::string* atom = &m_storage.emplace_back(str);
+        m_index[*atom]          = atom;
+        return atom;
+    }
+
+private:
+    std::shared_mutex                                        m_mutex;
+    std::deque<std::string>                                  m_storage;
+    std::unordered_map<std::string_view, const std::string*> m_index;
+};
+
+AtomTable& atomTable()
+{
+    static AtomTable s_table;
+    return s_table;
+}
+
+}
+
+PropertyTreeKey PropertyTreeKey::intern(std::string_view str)
+{
+    PropertyTreeKey result;
+    result.m_data = atomTable().intern(str);
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& stream, const PropertyTreeKey& key)
+{
+    return stream << key.str();
+}
+
+}
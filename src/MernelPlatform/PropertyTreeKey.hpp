@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "MernelPlatformExport.hpp"
+
+#include <compare>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace Mernel {
+
+class PropertyTreeKey;
+
+template<class T>
+concept PropertyTreeKeyComparable = std::is_convertible_v<const T&, std::string_view> && !std::is_same_v<T, PropertyTreeKey>;
+
+/**
+ * @brief Key of PropertyTree map.
+ *
+ * Key either owns its string, or refers to an atom - string interned in global process-wide table.
+ * Atoms are never freed, so only intern keys from a limited set (field names), not arbitrary user data.
+ * Two atoms are equal only if they are the same pointer, so comparing atoms does not touch string data.
+ *
+ * Key is implicitly convertible to const std::string&, so most code can treat it as a string.
+ */
+class MERNELPLATFORM_EXPORT PropertyTreeKey {
+public:
+    PropertyTreeKey() = default;
+    explicit PropertyTreeKey(std::string str)
+        : m_data(std::move(str))
+    {}
+    explicit PropertyTreeKey(std::string_view str)
+        : m_data(std::string(str))
+    {}
+    explicit PropertyTreeKey(const char* str)
+        : m_data(std::string(str))
+    {}
+
+    /// Returns atom key from global table. Thread-safe.
+    [[nodiscard]] static PropertyTreeKey intern(std::string_view str);
+
+    [[nodiscard]] bool isAtom() const noexcept { return std::holds_alternative<const std::string*>(m_data); }
+
+    const std::string& str() const noexcept
+    {
+        if (const auto* atom = std::get_if<const std::string*>(&m_data))
+            return **atom;
+        return *std::get_if<std::string>(&m_data);
+    }
+    std::string_view   view() const noexcept { return str(); }
+    const char*        c_str() const noexcept { return str().c_str(); }
+    size_t             size() const noexcept { return str().size(); }
+    bool               empty() const noexcept { return str().empty(); }
+
+    operator const std::string&() const noexcept { return str(); }
+
+    friend bool operator==(const PropertyTreeKey& l, const PropertyTreeKey& r) noexcept
+    {
+        if (l.isAtom() && r.isAtom())
+            return l.atom() == r.atom();
+        return l.str() == r.str();
+    }
+    friend std::strong_ordering operator<=>(const PropertyTreeKey& l, const PropertyTreeKey& r) noexcept
+    {
+        if (l.isAtom() && l.atom() == r.atom())
+            return std::strong_ordering::equal;
+        return l.view() <=> r.view();
+    }
+
+    template<PropertyTreeKeyComparable T>
+    friend bool operator==(const PropertyTreeKey& l, const T& r) noexcept
+    {
+        return l.view() == std::string_view(r);
+    }
+    template<PropertyTreeKeyComparable T>
+    friend std::strong_ordering operator<=>(const PropertyTreeKey& l, const T& r) noexcept
+    {
+        return l.view() <=> std::string_view(r);
+    }
+
+    MERNELPLATFORM_EXPORT friend std::ostream& operator<<(std::ostream& stream, const PropertyTreeKey& key);
+
+private:
+    const std::string* atom() const noexcept
+    {
+        const auto* atom = std::get_if<const std::string*>(&m_data);
+        return atom ? *atom : nullptr;
+    }
+
+    // owned string or atom pointer.
+    std::variant<std::string, const std::string*> m_data;
+};
+
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "PropertyTreePath.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+namespace Mernel {
+
+PropertyTreePath PropertyTreePath::fromPointer(std::string_view pointer) noexcept(false)
+{
+    return parsePointer(pointer, false);
+}
+
+PropertyTreePath PropertyTreePath::fromPointerPattern(std::string_view pointer) noexcept(false)
+{
+    return parsePointer(pointer, true);
+}
+
+PropertyTreePath PropertyTreePath::parsePointer(std::string_view pointer, bool allowWildcards) noexcept(false)
+{
+    PropertyTreePath result;
+    if (pointer.empty())
+        return result;
+    if (pointer[0] != '/')
+        throw std::runtime_error("JSON Pointer must start with '/': " + std::string(pointer));
+
+    size_t pos = 1;
+    while (true) {
+        const size_t     end = std::min(pointer.find('/', pos), pointer.size());
+        std::string_view raw = pointer.substr(pos, end - pos);
+
+        std::string key;
+        key.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] != '~') {
+                key += raw[i];
+                continue;
+            }
+            const char escaped = i + 1 < raw.size() ? raw[++i] : '\0';
+            if (escaped == '0')
+                key += '~';
+            else if (escaped == '1')
+                key += '/';
+            else
+                throw std::runtime_error("Invalid escape in JSON Pointer: " + std::string(pointer));
+        }
+        result.addSegment(std::move(key), allowWildcards);
+
+        if (end == pointer.size())
+            break;
+        pos = end + 1;
+    }
+    return result;
+}
+
+PropertyTreePath PropertyTreePath::fromDotted(std::string_view path) noexcept(false)
+{
+    PropertyTreePath result;
+    if (path.empty())
+        return result;
+
+    size_t pos = 0;
+    while (true) {
+        const size_t end = std::min(path.find('.', pos), path.size());
+        result.addSegment(std::string(path.substr(pos, end - pos)), true);
+        if (end == path.size())
+            break;
+        pos = end + 1;
+    }
+    return result;
+}
+
+const PropertyTree* PropertyTreePath::resolve(const PropertyTree& root) const noexcept
+{
+    if (m_hasWildcards)
+        return findFirst(root, 0);
+
+    const PropertyTree* node = &root;
+    for (const Segment& segment : m_segments) {
+        node = child(*node, segment);
+        if (!node)
+            return nullptr;
+    }
+    return node;
+}
+
+std::string PropertyTreePath::toPointer() const noexcept(false)
+{
+    std::string result;
+    for (const Segment& segment : m_segments) {
+        result += '/';
+        for (char c : segment.m_key) {
+            if (c == '~')
+                result += "~0";
+            else if (c == '/')
+                result += "~1";
+            else
+                result += c;
+        }
+    }
+    return result;
+}
+
+void PropertyTreePath::addSegment(std::string key, bool allowWildcards)
+{
+    Segment segment;
+    segment.m_isWildcard = allowWildcards && key == "*";
+    m_hasWildcards       = m_hasWildcards || segment.m_isWildcard;
+
+    // RFC 6901 array index: "0" or digits without leading zero.
+    const bool isIndex = !key.empty() && (key.size() == 1 || key[0] != '0')
+                         && key.find_first_not_of("0123456789") == std::string::npos;
+    if (isIndex) {
+        size_t     index = 0;
+        const auto res   = std::from_chars(key.data(), key.data() + key.size(), index);
+        if (res.ec == std::errc{})
+            segment.m_index = index;
+    }
+    segment.m_key = std::move(key);
+    m_segments.push_back(std::move(segment));
+}
+
+const PropertyTree* PropertyTreePath::child(const PropertyTree& node, const Segment& segment) noexcept
+{
+    if (node.isMap())
+        return node.find(std::string_view(segment.m_key));
+    if (node.isList() && segment.m_index != Segment::s_noIndex) {
+        const auto& list = node.getList();
+        return segment.m_index < list.size() ? &list[segment.m_index] : nullptr;
+    }
+    return nullptr;
+}
+
+const PropertyTree* PropertyTreePath::findFirst(const PropertyTree& node, size_t segmentIndex) const noexcept
+{
+    if (segmentIndex == m_segments.size())
+        return &node;
+    const Segment& segment = m_segments[segmentIndex];
+    if (!segment.m_isWildcard) {
+        const PropertyTree* next = child(node, segment);
+        return next ? findFirst(*next, segmentIndex + 1) : nullptr;
+    }
+    // stops at the first match, remaining children are not visited.
+    if (node.isList()) {
+        for (const PropertyTree& next : node.getList()) {
+            if (const PropertyTree* result = findFirst(next, segmentIndex + 1))
+                return result;
+        }
+    } else if (node.isMap()) {
+        for (const auto& [key, next] : node.getMap()) {
+            if (const PropertyTree* result = findFirst(next, segmentIndex + 1))
+                return result;
+        }
+    }
+    return nullptr;
+}
+
+}
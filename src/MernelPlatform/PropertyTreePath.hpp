@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "PropertyTree.hpp"
+
+#include "MernelPlatformExport.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mernel {
+
+/**
+ * @brief Path to a value inside PropertyTree, parsed once and resolved against any number of trees.
+ *
+ * Segment matches map key, or list index if it is a decimal number without leading zeros.
+ * Patterns (fromPointerPattern(), fromDotted()) may also contain wildcard segment "*": it matches every child of a list or map.
+ * Resolving does not allocate memory and does not modify the tree.
+ *
+ * General usage:
+ *
+ * static const PropertyTreePath s_port = PropertyTreePath::fromPointer("/server/listen/0/port");
+ * if (const PropertyTree* port = s_port.resolve(config))
+ *     ...
+ */
+class MERNELPLATFORM_EXPORT PropertyTreePath {
+public:
+    PropertyTreePath() = default;
+
+    /// RFC 6901 JSON Pointer: "" is the root, otherwise every segment starts with '/'; "~0" is '~' and "~1" is '/'.
+    /// Every segment is a literal key, so "/*" refers to key "*".
+    static PropertyTreePath fromPointer(std::string_view pointer) noexcept(false);
+    /// JSON Pointer syntax where segment "*" is a wildcard, e.g. "/servers/*/port". Key "*" can not be expressed.
+    static PropertyTreePath fromPointerPattern(std::string_view pointer) noexcept(false);
+    /// Dot-separated pattern, e.g. "server.listen.0.port" or "servers.*.port". Keys containing '.' or equal to "*" can not be expressed.
+    static PropertyTreePath fromDotted(std::string_view path) noexcept(false);
+
+    /// Returns first matching value or nullptr.
+    const PropertyTree* resolve(const PropertyTree& root) const noexcept;
+
+    /// Calls callback(const PropertyTree&) for every match, in tree order.
+    template<class Callback>
+    void forEach(const PropertyTree& root, Callback&& callback) const
+    {
+        visit(root, 0, callback);
+    }
+
+    /// Appends all matches to result.
+    void resolveAll(const PropertyTree& root, std::vector<const PropertyTree*>& result) const noexcept(false)
+    {
+        forEach(root, [&result](const PropertyTree& value) { result.push_back(&value); });
+    }
+
+    bool   hasWildcards() const noexcept { return m_hasWildcards; }
+    size_t size() const noexcept { return m_segments.size(); }
+
+    /// Path in JSON Pointer notation; wildcards are written as "*", so the result of a pattern is read back by fromPointerPattern().
+    std::string toPointer() const noexcept(false);
+
+private:
+    struct Segment {
+        static constexpr size_t s_noIndex = size_t(-1);
+
+        std::string m_key;
+        size_t      m_index      = s_noIndex;
+        bool        m_isWildcard = false;
+    };
+
+    static PropertyTreePath parsePointer(std::string_view pointer, bool allowWildcards) noexcept(false);
+
+    void addSegment(std::string key, bool allowWildcards);
+
+    static const PropertyTree* child(const PropertyTree& node, const Segment& segment) noexcept;
+
+    const PropertyTree* findFirst(const PropertyTree& node, size_t segmentIndex) const noexcept;
+
+    template<class Callback>
+    void visit(const PropertyTree& node, size_t segmentIndex, Callback& callback) const
+    {
+        if (segmentIndex == m_segments.size()) {
+            callback(node);
+            return;
+        }
+        const Segment& segment = m_segments[segmentIndex];
+        if (!segment.m_isWildcard) {
+            if (const PropertyTree* next = child(node, segment))
+                visit(*next, segmentIndex + 1, callback);
+            return;
+        }
+        if (node.isList()) {
+            for (const PropertyTree& next : node.getList())
+                visit(next, segmentIndex + 1, callback);
+        } else if (node.isMap()) {
+            for (const auto& [key, next] : node.getMap())
+                visit(next, segmentIndex + 1, callback);
+        }
+    }
+
+    std::vector<Segment> m_segments;
+    bool                 m_hasWildcards = false;
+};
+
+}
@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "PropertyTreeSchema.hpp"
+
+#include "NumberFormat.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+namespace Mernel {
+
+namespace {
+
+enum TypeMask : uint8_t
+{
+    TypeNull    = 1 << 0,
+    TypeBoolean = 1 << 1,
+    TypeInteger = 1 << 2,
+    TypeNumber  = 1 << 3,
+    TypeString  = 1 << 4,
+    TypeArray   = 1 << 5,
+    TypeObject  = 1 << 6,
+    TypeAny     = 0x7F,
+};
+
+constexpr std::pair<std::string_view, uint8_t> s_typeNames[] = {
+    { "null", TypeNull },
+    { "boolean", TypeBoolean },
+    { "integer", TypeInteger },
+    { "number", TypeNumber | TypeInteger },
+    { "string", TypeString },
+    { "array", TypeArray },
+    { "object", TypeObject },
+};
+
+uint8_t parseType(const PropertyTree& type)
+{
+    const std::string_view name = type.isScalar() ? type.getScalar().toStringView() : std::string_view();
+    for (const auto& [typeName, mask] : s_typeNames) {
+        if (typeName == name)
+            return mask;
+    }
+    throw std::runtime_error("Schema: unknown type '" + std::string(name) + "'");
+}
+
+uint8_t valueType(const PropertyTree& value)
+{
+    if (value.isList())
+        return TypeArray;
+    if (value.isMap())
+        return TypeObject;
+    if (!value.isScalar())
+        return TypeNull;
+    const auto& scalar = value.getScalar();
+    if (scalar.isBool())
+        return TypeBoolean;
+    if (scalar.isInt())
+        return TypeInteger;
+    if (scalar.isDouble()) {
+        const double number = scalar.toDouble();
+        return std::isfinite(number) && std::trunc(number) == number ? (TypeNumber | TypeInteger) : TypeNumber;
+    }
+    if (scalar.isString())
+        return TypeString;
+    return TypeNull;
+}
+
+std::string typeName(uint8_t type)
+{
+    if (type & TypeNumber)
+        return "number";
+    for (const auto& [typeName, mask] : s_typeNames) {
+        if (type == mask)
+            return std::string(typeName);
+    }
+    return "unknown";
+}
+
+std::optional<double> getNumber(const PropertyTree& schema, std::string_view key)
+{
+    const PropertyTree* value = schema.find(key);
+    if (!value)
+        return std::nullopt;
+    if (!value->isScalar() || !(valueType(*value) & (TypeInteger | TypeNumber)))
+        throw std::runtime_error("Schema: '" + std::string(key) + "' must be a number");
+    return value->getScalar().toDouble();
+}
+
+std::optional<size_t> getCount(const PropertyTree& schema, std::string_view key)
+{
+    const auto number = getNumber(schema, key);
+    if (!number)
+        return std::nullopt;
+    if (*number < 0)
+        throw std::runtime_error("Schema: '" + std::string(key) + "' must be non-negative");
+    return static_cast<size_t>(*number);
+}
+
+size_t utf8Length(std::string_view str)
+{
+    return std::count_if(str.cbegin(), str.cend(), [](char c) { return (static_cast<uint8_t>(c) & 0xC0) != 0x80; });
+}
+
+void appendPointerSegment(std::string& path, std::string_view key)
+{
+    path += '/';
+    for (char c : key) {
+        if (c == '~')
+            path += "~0";
+        else if (c == '/')
+            path += "~1";
+        else
+            path += c;
+    }
+}
+
+// integers are compared exactly, as int64 may not fit into double.
+constexpr double s_int64Bound = 9223372036854775808.0;
+
+bool isLess(const PropertyTreeScalar& scalar, double bound)
+{
+    if (!scalar.isInt())
+        return scalar.toDouble() < bound;
+    if (bound > -s_int64Bound && bound < s_int64Bound)
+        return scalar.toInt() < static_cast<int64_t>(std::ceil(bound));
+    return bound > 0;
+}
+
+bool isGreater(const PropertyTreeScalar& scalar, double bound)
+{
+    if (!scalar.isInt())
+        return scalar.toDouble() > bound;
+    if (bound > -s_int64Bound && bound < s_int64Bound)
+        return scalar.toInt() > static_cast<int64_t>(std::floor(bound));
+    return bound < 0;
+}
+
+}
+
+struct PropertyTreeSchema::Node {
+    uint8_t                   m_types = TypeAny;
+    std::vector<PropertyTree> m_enum;
+
+    std::optional<double> m_minimum;
+    std::optional<double> m_maximum;
+    std::optional<size_t> m_minLength;
+    std::optional<size_t> m_maxLength;
+    std::optional<size_t> m_minItems;
+    std::optional<size_t> m_maxItems;
+
+    std::unique_ptr<Node> m_items;
+
+    // both sorted by name, like PropertyTreeMap keys.
+    std::vector<std::pair<std::string, std::unique_ptr<Node>>> m_properties;
+    std::vector<std::string>                                   m_required;
+
+    bool                  m_additionalAllowed = true;
+    std::unique_ptr<Node> m_additional;
+
+    static std::unique_ptr<Node> compile(const PropertyTree& schema)
+    {
+        auto node = std::make_unique<Node>();
+        if (schema.isScalar() && schema.getScalar().isBool()) {
+            // boolean schema: true accepts anything, false nothing.
+            if (!schema.getScalar().toBool())
+                node->m_types = 0;
+            return node;
+        }
+        if (!schema.isMap())
+            throw std::runtime_error("Schema: object expected");
+
+        if (const PropertyTree* type = schema.find("type")) {
+            if (type->isList()) {
+                node->m_types = 0;
+                for (const PropertyTree& item : type->getList())
+                    node->m_types |= parseType(item);
+            } else {
+                node->m_types = parseType(*type);
+            }
+        }
+        if (const PropertyTree* values = schema.find("enum")) {
+            if (!values->isList())
+                throw std::runtime_error("Schema: 'enum' must be an array");
+            node->m_enum.assign(values->getList().cbegin(), values->getList().cend());
+        }
+
+        node->m_minimum   = getNumber(schema, "minimum");
+        node->m_maximum   = getNumber(schema, "maximum");
+        node->m_minLength = getCount(schema, "minLength");
+        node->m_maxLength = getCount(schema, "maxLength");
+        node->m_minItems  = getCount(schema, "minItems");
+        node->m_maxItems  = getCount(schema, "maxItems");
+
+        if (const PropertyTree* items = schema.find("items"))
+            node->m_items = compile(*items);
+
+        if (const PropertyTree* properties = schema.find("properties")) {
+            if (!properties->isMap())
+                throw std::runtime_error("Schema: 'properties' must be an object");
+            for (const auto& [name, propertySchema] : properties->getMap())
+                node->m_properties.emplace_back(name.str(), compile(propertySchema));
+        }
+        if (const PropertyTree* required = schema.find("required")) {
+            if (!required->isList())
+                throw std::runtime_error("Schema: 'required' must be an array");
+            for (const PropertyTree& name : required->getList()) {
+                if (!name.isScalar() || !name.getScalar().isString())
+                    throw std::runtime_error("Schema: 'required' must contain strings");
+                node->m_required.emplace_back(name.getScalar().toStringView());
+            }
+            std::sort(node->m_required.begin(), node->m_required.end());
+        }
+        if (const PropertyTree* additional = schema.find("additionalProperties")) {
+            if (additional->isScalar() && additional->getScalar().isBool())
+                node->m_additionalAllowed = additional->getScalar().toBool();
+            else
+                node->m_additional = compile(*additional);
+        }
+        return node;
+    }
+};
+
+class PropertyTreeSchema::Validator {
+public:
+    Validator(ErrorList* errors)
+        : m_errors(errors)
+    {}
+
+    // returns false on first error if there is no error list to fill.
+    bool validate(const Node& node, const PropertyTree& value)
+    {
+        const uint8_t type = valueType(value);
+        if (!(type & node.m_types)) {
+            if (!node.m_types)
+                return error("no value is allowed here");
+            std::string expected;
+            for (const auto& [name, mask] : s_typeNames) {
+                if ((node.m_types & mask) == mask && (mask != TypeInteger || !(node.m_types & TypeNumber)))
+                    expected += (expected.empty() ? "" : " or ") + std::string(name);
+            }
+            return error("expected " + expected + ", got " + typeName(type));
+        }
+
+        if (!node.m_enum.empty() && std::find(node.m_enum.cbegin(), node.m_enum.cend(), value) == node.m_enum.cend()) {
+            if (!error("value is not one of allowed values"))
+                return false;
+        }
+
+        if (type & (TypeInteger | TypeNumber))
+            return validateNumber(node, value.getScalar());
+        if (type == TypeString)
+            return validateString(node, value.getScalar().toStringView());
+        if (type == TypeArray)
+            return validateArray(node, value.getList());
+        if (type == TypeObject)
+            return validateObject(node, value.getMap());
+        return true;
+    }
+
+private:
+    bool error(std::string message)
+    {
+        if (!m_errors)
+            return false;
+        m_errors->push_back({ m_path, std::move(message) });
+        m_valid = false;
+        return true;
+    }
+
+    bool validateNumber(const Node& node, const PropertyTreeScalar& scalar)
+    {
+        if (node.m_minimum && isLess(scalar, *node.m_minimum) && !error("value is less than minimum " + numberToString(*node.m_minimum)))
+            return false;
+        if (node.m_maximum && isGreater(scalar, *node.m_maximum) && !error("value is greater than maximum " + numberToString(*node.m_maximum)))
+            return false;
+        return true;
+    }
+
+    bool validateString(const Node& node, std::string_view str)
+    {
+        if (!node.m_minLength && !node.m_maxLength)
+            return true;
+        const size_t length = utf8Length(str);
+        if (node.m_minLength && length < *node.m_minLength && !error("string is shorter than " + std::to_string(*node.m_minLength)))
+            return false;
+        if (node.m_maxLength && length > *node.m_maxLength && !error("string is longer than " + std::to_string(*node.m_maxLength)))
+            return false;
+        return true;
+    }
+
+    bool validateArray(const Node& node, const PropertyTreeList& list)
+    {
+        if (node.m_minItems && list.size() < *node.m_minItems && !error("array has less than " + std::to_string(*node.m_minItems) + " items"))
+            return false;
+        if (node.m_maxItems && list.size() > *node.m_maxItems && !error("array has more than " + std::to_string(*node.m_maxItems) + " items"))
+            return false;
+        if (!node.m_items)
+            return true;
+
+        const size_t pathSize = m_path.size();
+        for (size_t i = 0; i < list.size(); ++i) {
+            m_path += '/';
+            m_path += std::to_string(i);
+            const bool result = validate(*node.m_items, list[i]);
+            m_path.resize(pathSize);
+            if (!result)
+                return false;
+        }
+        return true;
+    }
+
+    bool validateObject(const Node& node, const PropertyTreeMap& map)
+    {
+        const size_t pathSize = m_path.size();
+        for (const std::string& name : node.m_required) {
+            if (map.find(std::string_view(name)) != map.end())
+                continue;
+            appendPointerSegment(m_path, name);
+            const bool result = error("required property is missing");
+            m_path.resize(pathSize);
+            if (!result)
+                return false;
+        }
+
+        // members and declared properties are both sorted, so they are matched in one pass.
+        auto property = node.m_properties.cbegin();
+        for (const auto& [key, child] : map) {
+            const std::string_view keyView = key.view();
+            while (property != node.m_properties.cend() && std::string_view(property->first) < keyView)
+                ++property;
+
+            const Node* childNode = nullptr;
+            if (property != node.m_properties.cend() && property->first == keyView)
+                childNode = property->second.get();
+            else if (node.m_additional)
+                childNode = node.m_additional.get();
+
+            appendPointerSegment(m_path, keyView);
+            bool result = true;
+            if (childNode)
+                result = validate(*childNode, child);
+            else if (!node.m_additionalAllowed)
+                result = error("property is not allowed");
+            m_path.resize(pathSize);
+            if (!result)
+                return false;
+        }
+        return true;
+    }
+
+public:
+    bool m_valid = true;
+
+private:
+    ErrorList*  m_errors;
+    std::string m_path;
+};
+
+PropertyTreeSchema::PropertyTreeSchema() noexcept                                = default;
+PropertyTreeSchema::~PropertyTreeSchema()                                        = default;
+PropertyTreeSchema::PropertyTreeSchema(PropertyTreeSchema&&) noexcept            = default;
+PropertyTreeSchema& PropertyTreeSchema::operator=(PropertyTreeSchema&&) noexcept = default;
+
+PropertyTreeSchema PropertyTreeSchema::compile(const PropertyTree& schema) noexcept(false)
+{
+    PropertyTreeSchema result;
+    result.m_root = Node::compile(schema);
+    return result;
+}
+
+bool PropertyTreeSchema::validate(const PropertyTree& value, ErrorList& errors) const noexcept(false)
+{
+    if (!m_root)
+        return true;
+    Validator validator(&errors);
+    validator.validate(*m_root, value);
+    return validator.m_valid;
+}
+
+bool PropertyTreeSchema::isValid(const PropertyTree& value) const noexcept(false)
+{
+    if (!m_root)
+        return true;
+    Validator validator(nullptr);
+    return validator.validate(*m_root, value);
+}
+
+}
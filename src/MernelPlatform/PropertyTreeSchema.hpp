@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "PropertyTree.hpp"
+
+#include "MernelPlatformExport.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Mernel {
+
+/**
+ * @brief Validator compiled from a JSON Schema subset.
+ *
+ * Supported keywords: type (string or list of "null", "boolean", "integer", "number", "string", "array", "object"),
+ * enum, minimum, maximum, minLength, maxLength, minItems, maxItems, items (single schema), properties, required,
+ * additionalProperties (bool or schema). Other keywords are ignored.
+ * Double with integral value is accepted as "integer", string length is counted in UTF-8 code points.
+ *
+ * Schema is compiled once; validation is a single pass over the document, which reports JSON Pointer of each invalid value.
+ */
+class MERNELPLATFORM_EXPORT PropertyTreeSchema {
+public:
+    struct Error {
+        std::string m_path; ///< JSON Pointer to invalid value, "" is the root.
+        std::string m_message;
+    };
+    using ErrorList = std::vector<Error>;
+
+    PropertyTreeSchema() noexcept;
+    ~PropertyTreeSchema();
+    PropertyTreeSchema(PropertyTreeSchema&&) noexcept;
+    PropertyTreeSchema& operator=(PropertyTreeSchema&&) noexcept;
+
+    /// Throws if schema itself is malformed.
+    static PropertyTreeSchema compile(const PropertyTree& schema) noexcept(false);
+
+    /// Appends all found errors; returns true if there are none. Empty (default-constructed) schema accepts anything.
+    bool validate(const PropertyTree& value, ErrorList& errors) const noexcept(false);
+    bool isValid(const PropertyTree& value) const noexcept(false);
+
+private:
+    struct Node;
+    class Validator;
+    std::unique_ptr<Node> m_root;
+};
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace Mernel {
+
+/**
+ * @brief std::map with the interface of FlatMap, so code building and querying maps can be written once for both.
+ *
+ * Unlike FlatMap, insertion and erase never invalidate references and iterators to other elements.
+ * Lookup, operator[], at() and erase() accept any key comparable with Key, same as in FlatMap.
+ */
+template<class Key, class Value, class Compare = std::less<>, class Allocator = std::allocator<std::pair<const Key, Value>>>
+class StableMap : public std::map<Key, Value, Compare, Allocator> {
+    using Base = std::map<Key, Value, Compare, Allocator>;
+
+public:
+    using typename Base::const_iterator;
+    using typename Base::iterator;
+    using typename Base::size_type;
+
+    using Base::Base;
+    using Base::erase;
+
+    template<class K>
+    Value& at(const K& key)
+    {
+        auto it = this->find(key);
+        if (it == this->end())
+            throw std::out_of_range("StableMap::at: key not found");
+        return it->second;
+    }
+    template<class K>
+    const Value& at(const K& key) const
+    {
+        auto it = this->find(key);
+        if (it == this->end())
+            throw std::out_of_range("StableMap::at: key not found");
+        return it->second;
+    }
+
+    template<class K>
+    Value& operator[](K&& key)
+    {
+        return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        auto it = this->lower_bound(key);
+        if (it != this->end() && !this->key_comp()(key, it->first))
+            return { it, false };
+
+        it = this->emplace_hint(it,
+                                std::piecewise_construct,
+                                std::forward_as_tuple(std::forward<K>(key)),
+                                std::forward_as_tuple(std::forward<Args>(args)...));
+        return { it, true };
+    }
+
+    template<class K>
+    size_type erase(const K& key)
+    {
+        auto it = this->find(key);
+        if (it == this->end())
+            return 0;
+        Base::erase(it);
+        return 1;
+    }
+
+    /// Elements are visited in key order.
+    template<class Predicate>
+    size_type erase_if(Predicate pred)
+    {
+        return std::erase_if(static_cast<Base&>(*this), pred);
+    }
+
+    /// No-op, storage is not contiguous.
+    void reserve(size_type) noexcept {}
+
+    /// Same contract as FlatMap::appendUnsorted(): for duplicate keys the last appended value wins.
+    /// Appending keys in ascending order is amortized O(1).
+    template<class K>
+    Value& appendUnsorted(K&& key)
+    {
+        const size_type size = this->size();
+        auto            it   = this->emplace_hint(this->end(), std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple());
+        if (this->size() == size)
+            it->second = Value();
+        return it->second;
+    }
+    /// No-op, elements are always sorted.
+    void sortAppended() noexcept {}
+};
+
+}
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "PropertyTreeReader.hpp"
+
+#include "MernelPlatform/FileFormatJsonView.hpp"
+
+#include <frozen/unordered_map.h>
+
+#include <bitset>
+
+namespace Mernel::Reflection {
+
+namespace details {
+template<class T, size_t... I>
+constexpr auto makeFieldIndex(std::index_sequence<I...>)
+{
+    constexpr auto& fields = MetaInfo::MetaFields<T>::s_fields;
+    return frozen::make_unordered_map(std::array<std::pair<frozen::string, size_t>, sizeof...(I)>{ { { std::get<I>(fields).m_name, I }... } });
+}
+
+/// Compile-time perfect hash from field name to its index in MetaFields<T>::s_fields.
+template<class T>
+static inline constexpr auto s_fieldIndex = makeFieldIndex<T>(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<decltype(MetaInfo::MetaFields<T>::s_fields)>>>{});
+
+/// Reads subtrees for JsonCursorReaderBase; types PropertyTreeReaderBase does not handle go to CustomReader::jsonToValueImpl(const PropertyTree&, T&).
+template<class CustomReader>
+class TreeReaderForward : public PropertyTreeReaderBase<TreeReaderForward<CustomReader>> {
+public:
+    explicit TreeReaderForward(CustomReader& custom)
+        : m_custom(custom)
+    {}
+
+    template<class T>
+    void jsonToValueImpl(const PropertyTree& json, T& value)
+    {
+        m_custom.jsonToValueImpl(json, value);
+    }
+
+private:
+    CustomReader& m_custom;
+};
+}
+
+/**
+ * @brief Reads reflected structures directly from JSON text, without rapidjson document and PropertyTree.
+ *
+ * Same rules as PropertyTreeReaderBase apply. Object members are read in document order and dispatched to fields
+ * with compile-time hash of field names; unknown members are skipped. Types with custom tree transform or
+ * convertFromJson() are read into a PropertyTree subtree and passed to PropertyTreeReaderBase, which forwards
+ * types it does not handle to CustomReader::jsonToValueImpl(const PropertyTree&, T&).
+ */
+template<class CustomReader>
+class JsonCursorReaderBase {
+public:
+    template<class T>
+    void readFromBuffer(const std::string& buffer, T& value)
+    {
+        JsonCursor cursor(buffer);
+        jsonToValue(cursor, value);
+    }
+
+    template<class T>
+    void jsonToValueUsingMeta(JsonCursor& cursor, T& value)
+    {
+        if (!cursor.isMap())
+            throw std::runtime_error("Invalid variant access, map expected");
+
+        constexpr auto& fields     = MetaInfo::MetaFields<T>::s_fields;
+        constexpr auto  fieldCount = std::tuple_size_v<std::remove_cvref_t<decltype(fields)>>;
+
+        std::bitset<fieldCount> found;
+        std::string_view        key;
+        cursor.enterMap();
+        while (cursor.nextMember(key)) {
+            if constexpr (fieldCount > 0) {
+                auto it = details::s_fieldIndex<T>.find(frozen::string(key));
+                if (it == details::s_fieldIndex<T>.end())
+                    continue;
+                const size_t index = it->second;
+                found.set(index);
+                readField(cursor, value, index, std::make_index_sequence<fieldCount>{});
+            }
+        }
+
+        if (!m_resetToDefault || found.all())
+            return;
+        if constexpr (std::is_default_constructible_v<T>) {
+            size_t index   = 0;
+            auto   visitor = [&value, &found, &index](auto&& field) {
+                if (!found.test(index++)) {
+                    const T& defParent = MetaInfo::getDefaultConstructed<T>();
+                    auto     defValue  = field.get(defParent);
+                    auto     writer    = field.makeValueWriter(value);
+                    writer.getRef()    = std::move(defValue);
+                }
+            };
+            std::apply([&visitor](auto&&... field) { ((visitor(field)), ...); }, fields);
+        }
+    }
+
+    template<HasFieldsForRead T>
+    void jsonToValue(JsonCursor& cursor, T& value)
+    {
+        jsonToValueUsingMeta(cursor, value);
+    }
+
+    void jsonToValue(JsonCursor& cursor, PropertyTreeScalarHeld auto& value)
+    {
+        cursor.readScalar().convertTo(value);
+    }
+
+    template<IsEnum Enum>
+    void jsonToValue(JsonCursor& cursor, Enum& value)
+    {
+        PropertyTreeScalar scalar;
+        if (cursor.isScalar())
+            scalar = cursor.readScalar();
+        else
+            cursor.skip();
+        const std::string_view str = scalar.toStringView();
+        value                      = EnumTraits::stringToEnum<Enum>({ str.data(), str.size() });
+    }
+
+    template<HasCustomTransformRead T>
+    void jsonToValue(JsonCursor& cursor, T& value)
+    {
+        readUsingTree(cursor, value);
+    }
+
+    void jsonToValue(JsonCursor& cursor, HasFromStringRead auto& value)
+    {
+        if (!cursor.isScalar())
+            return jsonToValueUsingMeta(cursor, value);
+
+        const PropertyTreeScalar scalar = cursor.readScalar();
+        if (!scalar.isString())
+            throw std::runtime_error("Invalid variant access, map expected");
+        value.fromString(scalar.toString());
+    }
+
+    void jsonToValue(JsonCursor& cursor, HasFromJsonRead auto& value)
+    {
+        readUsingTree(cursor, value);
+    }
+
+    void jsonToValue(JsonCursor& cursor, HasFromJsonReadGlobal auto& value)
+    {
+        readUsingTree(cursor, value);
+    }
+
+    template<NonAssociative Container>
+    void jsonToValue(JsonCursor& cursor, Container& container)
+    {
+        if (!cursor.enterList())
+            return;
+        container.clear();
+        auto inserter = std::inserter(container, container.end());
+        while (cursor.nextElement()) {
+            typename Container::value_type value{};
+            jsonToValue(cursor, value);
+            *inserter = std::move(value);
+        }
+    }
+
+    template<IsStdArray Container>
+    void jsonToValue(JsonCursor& cursor, Container& container)
+    {
+        if (!cursor.enterList())
+            return;
+        size_t index = 0;
+        while (cursor.nextElement()) {
+            assert(index < container.size());
+            if (index >= container.size())
+                continue;
+            typename Container::value_type value{};
+            jsonToValue(cursor, value);
+            container[index++] = std::move(value);
+        }
+    }
+
+    template<IsStdOptional Container>
+    void jsonToValue(JsonCursor& cursor, Container& container)
+    {
+        if (!cursor.enterList())
+            return;
+        while (cursor.nextElement()) {
+            typename Container::value_type value{};
+            jsonToValue(cursor, value);
+            container = std::move(value);
+        }
+    }
+
+    template<IsMap Container>
+    void jsonToValue(JsonCursor& cursor, Container& container)
+    {
+        if (!cursor.enterList())
+            return;
+
+        while (cursor.nextElement()) {
+            typename Container::mapped_type value{};
+            typename Container::key_type    key{};
+            if (!cursor.enterMap())
+                throw std::runtime_error("Invalid variant access, map expected");
+            std::string_view memberName;
+            bool             hasKey = false, hasValue = false;
+            while (cursor.nextMember(memberName)) {
+                if (memberName == "key") {
+                    jsonToValue(cursor, key);
+                    hasKey = true;
+                } else if (memberName == "value") {
+                    jsonToValue(cursor, value);
+                    hasValue = true;
+                }
+            }
+            // same error as PropertyTreeReader gets from el["key"] / el["value"].
+            if (!hasKey || !hasValue)
+                throw std::out_of_range("PropertyTree: key not found");
+            container[key] = std::move(value);
+        }
+    }
+
+    template<IsStringMap Container>
+    void jsonToValue(JsonCursor& cursor, Container& container)
+    {
+        if (!cursor.enterMap())
+            return;
+
+        std::string_view keyString;
+        while (cursor.nextMember(keyString)) {
+            typename Container::key_type    key{};
+            typename Container::mapped_type value{};
+            makeTreeReader().jsonToValue(PropertyTree(PropertyTreeScalar(keyString)), key);
+            jsonToValue(cursor, value);
+            container[key] = std::move(value);
+        }
+    }
+
+    void jsonToValue(JsonCursor& cursor, IsEmptyType auto& container)
+    {
+        cursor.skip();
+    }
+
+    template<class T>
+    void jsonToValue(JsonCursor& cursor, T& value)
+    {
+        static_cast<CustomReader*>(this)->jsonToValueImpl(cursor, value);
+    }
+
+    bool m_resetToDefault = true;
+
+private:
+    template<class T, size_t... I>
+    void readField(JsonCursor& cursor, T& value, size_t index, std::index_sequence<I...>)
+    {
+        constexpr auto& fields = MetaInfo::MetaFields<T>::s_fields;
+
+        auto visitor = [&cursor, &value, this](auto&& field) {
+            auto writer = field.makeValueWriter(value);
+            this->jsonToValue(cursor, writer.getRef());
+        };
+        ((I == index ? (visitor(std::get<I>(fields)), true) : false) || ...);
+    }
+
+    template<class T>
+    void readUsingTree(JsonCursor& cursor, T& value)
+    {
+        const PropertyTree tree = cursor.readTree();
+        makeTreeReader().jsonToValue(tree, value);
+    }
+
+    details::TreeReaderForward<CustomReader> makeTreeReader()
+    {
+        details::TreeReaderForward<CustomReader> reader(*static_cast<CustomReader*>(this));
+        reader.m_resetToDefault = m_resetToDefault;
+        return reader;
+    }
+};
+
+class JsonCursorReader : public JsonCursorReaderBase<JsonCursorReader> {};
+
+}
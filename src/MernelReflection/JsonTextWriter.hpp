@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "PropertyTreeWriter.hpp"
+
+#include "MernelPlatform/FileFormatJsonEmitter.hpp"
+
+#include <algorithm>
+
+namespace Mernel::Reflection {
+
+namespace details {
+template<class T, size_t... I>
+constexpr auto makeSortedFieldOrder(std::index_sequence<I...>)
+{
+    constexpr auto&                   fields = MetaInfo::MetaFields<T>::s_fields;
+    std::array<size_t, sizeof...(I)>  order{ I... };
+    std::array<std::string_view, sizeof...(I)> names{ std::string_view(std::get<I>(fields).m_name.data(), std::get<I>(fields).m_name.size())... };
+    std::sort(order.begin(), order.end(), [&names](size_t l, size_t r) { return names[l] < names[r]; });
+    return order;
+}
+
+/// Field indices of MetaFields<T>::s_fields ordered by name - the order in which PropertyTree map stores them.
+template<class T>
+static inline constexpr auto s_sortedFieldOrder = makeSortedFieldOrder<T>(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<decltype(MetaInfo::MetaFields<T>::s_fields)>>>{});
+
+/// Writes subtrees for JsonTextWriterBase; types PropertyTreeWriterBase does not handle go to CustomWriter::valueToJsonImpl(const T&, PropertyTree&).
+template<class CustomWriter>
+class TreeWriterForward : public PropertyTreeWriterBase<TreeWriterForward<CustomWriter>> {
+public:
+    explicit TreeWriterForward(CustomWriter& custom)
+        : m_custom(custom)
+    {}
+
+    template<class T>
+    void valueToJsonImpl(const T& value, PropertyTree& result)
+    {
+        m_custom.valueToJsonImpl(value, result);
+    }
+
+private:
+    CustomWriter& m_custom;
+};
+}
+
+/**
+ * @brief Writes reflected structures directly as JSON text, without PropertyTree and rapidjson document.
+ *
+ * Output is byte-to-byte the same as PropertyTreeWriter followed by compact writeJsonToBuffer():
+ * fields are emitted sorted by name, m_skipDefault has the same meaning.
+ * Types with custom tree transform or convertToJson() are converted to PropertyTree subtree first, with PropertyTreeWriterBase
+ * forwarding types it does not handle to CustomWriter::valueToJsonImpl(const T&, PropertyTree&).
+ */
+template<class CustomWriter>
+class JsonTextWriterBase {
+public:
+    template<class T>
+    std::string writeToBuffer(const T& value)
+    {
+        std::string buffer;
+        JsonEmitter emitter(buffer);
+        valueToJson(value, emitter);
+        return buffer;
+    }
+
+    template<class T>
+    void valueToJsonUsingMeta(const T& value, JsonEmitter& out)
+    {
+        out.beginMap();
+        writeFields(value, out, std::make_index_sequence<details::s_sortedFieldOrder<T>.size()>{});
+        out.endMap();
+    }
+
+    void valueToJson(const HasFieldsForWrite auto& value, JsonEmitter& out)
+    {
+        valueToJsonUsingMeta(value, out);
+    }
+
+    template<PropertyTreeScalarHeld T>
+    void valueToJson(const T& value, JsonEmitter& out)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            out.writeBool(value);
+        else if constexpr (PropertyTreeIntegral<T>)
+            out.writeInt(static_cast<int64_t>(value));
+        else if constexpr (PropertyTreeFloating<T>)
+            out.writeDouble(static_cast<double>(value));
+        else
+            out.writeString(value);
+    }
+
+    void valueToJson(const IsEnum auto& value, JsonEmitter& out)
+    {
+        const auto str = EnumTraits::enumToString(value);
+        out.writeString(std::string_view(str.data(), str.size()));
+    }
+
+    template<HasCustomTransformWrite T>
+    void valueToJson(const T& value, JsonEmitter& out)
+    {
+        writeUsingTree(value, out);
+    }
+
+    void valueToJson(const HasToStringWrite auto& value, JsonEmitter& out)
+    {
+        out.writeString(value.toString());
+    }
+    void valueToJson(const HasToJsonWrite auto& value, JsonEmitter& out)
+    {
+        writeUsingTree(value, out);
+    }
+    void valueToJson(const HasToJsonWriteGlobal auto& value, JsonEmitter& out)
+    {
+        writeUsingTree(value, out);
+    }
+
+    void valueToJson(const NonAssociative auto& container, JsonEmitter& out)
+    {
+        out.beginList();
+        for (const auto& value : container)
+            valueToJson(value, out);
+        out.endList();
+    }
+
+    void valueToJson(const IsStdOptional auto& container, JsonEmitter& out)
+    {
+        out.beginList();
+        if (container.has_value())
+            valueToJson(container.value(), out);
+        out.endList();
+    }
+
+    void valueToJson(const IsMap auto& container, JsonEmitter& out)
+    {
+        out.beginList();
+        for (const auto& [key, value] : container) {
+            out.beginMap();
+            out.key("key");
+            valueToJson(key, out);
+            out.key("value");
+            valueToJson(value, out);
+            out.endMap();
+        }
+        out.endList();
+    }
+
+    template<IsStringMap Container>
+    void valueToJson(const Container& container, JsonEmitter& out)
+    {
+        // keys are converted to strings, and PropertyTree keeps them sorted; last value wins for duplicate keys.
+        std::vector<std::pair<std::string, const typename Container::mapped_type*>> entries;
+        entries.reserve(container.size());
+        for (const auto& [key, value] : container) {
+            PropertyTree childKey;
+            makeTreeWriter().valueToJson(key, childKey);
+            assert(childKey.isScalar() && childKey.getScalar().isString());
+            entries.emplace_back(childKey.getScalar().toString(), &value);
+        }
+        std::stable_sort(entries.begin(), entries.end(), [](const auto& l, const auto& r) { return l.first < r.first; });
+
+        out.beginMap();
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (i + 1 < entries.size() && entries[i].first == entries[i + 1].first)
+                continue;
+            out.key(entries[i].first);
+            valueToJson(*entries[i].second, out);
+        }
+        out.endMap();
+    }
+
+    void valueToJson(const IsEmptyType auto& container, JsonEmitter& out)
+    {
+        out.writeNull();
+    }
+
+    template<class T>
+    void valueToJson(const T& value, JsonEmitter& out)
+    {
+        static_cast<CustomWriter*>(this)->valueToJsonImpl(value, out);
+    }
+
+    // same flags as in PropertyTreeWriterBase, passed to it for subtrees. Text is always written from scratch,
+    // so m_clearMaps does not change the output.
+    bool m_clearMaps   = true;
+    bool m_skipDefault = true;
+
+private:
+    template<class T, size_t... K>
+    void writeFields(const T& value, JsonEmitter& out, std::index_sequence<K...>)
+    {
+        constexpr auto& fields = MetaInfo::MetaFields<T>::s_fields;
+
+        auto visitor = [&value, &out, this](auto&& field) {
+            const auto& fieldVal = field.get(value);
+            using FieldType      = std::remove_cvref_t<decltype(fieldVal)>;
+
+            if (m_skipDefault) {
+                if constexpr (std::is_default_constructible_v<T> && details::is_comparable<FieldType>()) {
+                    const T&         defParent = MetaInfo::getDefaultConstructed<T>();
+                    const FieldType& defValue  = field.get(defParent);
+                    if (fieldVal == defValue)
+                        return;
+                }
+            }
+            out.key(std::string_view(field.m_name.data(), field.m_name.size()));
+            this->valueToJson(fieldVal, out);
+        };
+        (visitor(std::get<details::s_sortedFieldOrder<T>[K]>(fields)), ...);
+    }
+
+    template<class T>
+    void writeUsingTree(const T& value, JsonEmitter& out)
+    {
+        PropertyTree tree;
+        makeTreeWriter().valueToJson(value, tree);
+        out.writeTree(tree);
+    }
+
+    details::TreeWriterForward<CustomWriter> makeTreeWriter()
+    {
+        details::TreeWriterForward<CustomWriter> writer(*static_cast<CustomWriter*>(this));
+        writer.m_clearMaps   = m_clearMaps;
+        writer.m_skipDefault = m_skipDefault;
+        return writer;
+    }
+};
+
+class JsonTextWriter : public JsonTextWriterBase<JsonTextWriter> {};
+
+}
@@ -40,9 +40,9 @@ public:
         const auto& jsonMap = json.getMap();
 
         auto visitor = [&value, &jsonMap, this](auto&& field) {
-            if (jsonMap.contains(field.name())) {
+            if (auto it = jsonMap.find(std::string_view(field.m_name.data(), field.m_name.size())); it != jsonMap.cend()) {
                 auto writer = field.makeValueWriter(value);
-                this->jsonToValue(jsonMap.at(field.name()), writer.getRef());
+                this->jsonToValue(it->second, writer.getRef());
             } else if (m_resetToDefault) {
                 if constexpr (std::is_default_constructible_v<T>) {
                     const T& defParent = MetaInfo::getDefaultConstructed<T>();
@@ -69,8 +69,8 @@ public:
     template<IsEnum Enum>
     void jsonToValue(const PropertyTree& json, Enum& value)
     {
-        const auto str = json.isScalar() ? json.getScalar().toString() : "";
-        value          = EnumTraits::stringToEnum<Enum>({ str.c_str(), str.size() });
+        const std::string_view str = json.isScalar() ? json.getScalar().toStringView() : std::string_view();
+        value                      = EnumTraits::stringToEnum<Enum>({ str.data(), str.size() });
     }
 
     template<HasCustomTransformRead T>
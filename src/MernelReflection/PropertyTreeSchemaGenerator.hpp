@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "PropertyTreeReader.hpp"
+
+#include "MernelPlatform/PropertyTreeSchema.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace Mernel::Reflection {
+
+/**
+ * @brief Makes JSON Schema (subset accepted by PropertyTreeSchema) describing what PropertyTreeReader can read into T.
+ *
+ * Fields are never required, as reader resets missing ones to default. Unknown keys are allowed, as reader ignores them;
+ * set m_additionalProperties to false for strict checking.
+ * Types with custom transform or own JSON conversion accept any value.
+ *
+ * General usage:
+ *
+ * static const PropertyTreeSchema s_schema = PropertyTreeSchemaGenerator().makeValidator<Config>();
+ * PropertyTreeSchema::ErrorList errors;
+ * if (s_schema.validate(json, errors))
+ *     reader.jsonToValue(json, config);
+ */
+template<class CustomGenerator>
+class PropertyTreeSchemaGeneratorBase {
+public:
+    template<class T>
+    PropertyTree makeSchema()
+    {
+        PropertyTree schema;
+        schema.convertToMap();
+        typeToSchema(schema, std::type_identity<T>{});
+        return schema;
+    }
+
+    template<class T>
+    PropertyTreeSchema makeValidator()
+    {
+        return PropertyTreeSchema::compile(makeSchema<T>());
+    }
+
+    template<class T>
+    void typeToSchemaUsingMeta(PropertyTree& schema)
+    {
+        schema["type"] = PropertyTreeScalar("object");
+        if (!m_additionalProperties)
+            schema["additionalProperties"] = PropertyTreeScalar(false);
+        auto& properties = schema["properties"];
+        properties.convertToMap();
+
+        auto visitor = [&properties, this](auto&& field) {
+            using FieldType = std::remove_cvref_t<decltype(field.get(std::declval<const T&>()))>;
+
+            auto& fieldSchema = properties[field.name()];
+            fieldSchema.convertToMap();
+            this->typeToSchema(fieldSchema, std::type_identity<FieldType>{});
+        };
+        std::apply([&visitor](auto&&... field) { ((visitor(field)), ...); }, MetaInfo::MetaFields<T>::s_fields);
+    }
+
+    template<HasFieldsForRead T>
+    void typeToSchema(PropertyTree& schema, std::type_identity<T>)
+    {
+        typeToSchemaUsingMeta<T>(schema);
+    }
+
+    template<PropertyTreeScalarHeld T>
+    void typeToSchema(PropertyTree& schema, std::type_identity<T>)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            schema["type"] = PropertyTreeScalar("boolean");
+        } else if constexpr (std::is_integral_v<T>) {
+            schema["type"] = PropertyTreeScalar("integer");
+            if constexpr (sizeof(T) < sizeof(int64_t)) {
+                schema["minimum"] = PropertyTreeScalar(static_cast<int64_t>(std::numeric_limits<T>::min()));
+                schema["maximum"] = PropertyTreeScalar(static_cast<int64_t>(std::numeric_limits<T>::max()));
+            } else if constexpr (std::is_unsigned_v<T>) {
+                schema["minimum"] = PropertyTreeScalar(0);
+            }
+        } else if constexpr (std::is_floating_point_v<T>) {
+            schema["type"] = PropertyTreeScalar("number");
+        } else {
+            schema["type"] = PropertyTreeScalar("string");
+        }
+    }
+
+    template<IsEnum Enum>
+    void typeToSchema(PropertyTree& schema, std::type_identity<Enum>)
+    {
+        schema["type"] = PropertyTreeScalar("string");
+
+        std::vector<std::string> names;
+        for (const auto& [name, value] : s_valueMapping<Enum>.m_toEnum)
+            names.push_back(std::string(name.data(), name.size()));
+        // frozen map order is a hash order; keep schema output stable.
+        std::sort(names.begin(), names.end());
+
+        auto& values = schema["enum"];
+        values.convertToList();
+        for (auto& name : names)
+            values.append(PropertyTreeScalar(std::move(name)));
+    }
+
+    template<HasCustomTransformRead T>
+    void typeToSchema(PropertyTree& schema, std::type_identity<T>)
+    {
+    }
+
+    template<HasFromStringRead T>
+    void typeToSchema(PropertyTree& schema, std::type_identity<T>)
+    {
+    }
+
+    template<HasFromJsonRead T>
+    void typeToSchema(PropertyTree& schema, std::type_identity<T>)
+    {
+    }
+
+    template<HasFromJsonReadGlobal T>
+    void typeToSchema(PropertyTree& schema, std::type_identity<T>)
+    {
+    }
+
+    template<NonAssociative Container>
+    void typeToSchema(PropertyTree& schema, std::type_identity<Container>)
+    {
+        schema["type"] = PropertyTreeScalar("array");
+        itemsToSchema<typename Container::value_type>(schema);
+    }
+
+    template<IsStdArray Container>
+    void typeToSchema(PropertyTree& schema, std::type_identity<Container>)
+    {
+        schema["type"]     = PropertyTreeScalar("array");
+        schema["maxItems"] = PropertyTreeScalar(static_cast<int64_t>(std::tuple_size_v<Container>));
+        itemsToSchema<typename Container::value_type>(schema);
+    }
+
+    template<IsStdOptional Container>
+    void typeToSchema(PropertyTree& schema, std::type_identity<Container>)
+    {
+        schema["type"]     = PropertyTreeScalar("array");
+        schema["maxItems"] = PropertyTreeScalar(1);
+        itemsToSchema<typename Container::value_type>(schema);
+    }
+
+    template<IsMap Container>
+    void typeToSchema(PropertyTree& schema, std::type_identity<Container>)
+    {
+        schema["type"] = PropertyTreeScalar("array");
+        auto& items    = schema["items"];
+        items.convertToMap();
+        items["type"] = PropertyTreeScalar("object");
+
+        auto& properties = items["properties"];
+        properties.convertToMap();
+        properties["key"].convertToMap();
+        properties["value"].convertToMap();
+        typeToSchema(properties["key"], std::type_identity<typename Container::key_type>{});
+        typeToSchema(properties["value"], std::type_identity<typename Container::mapped_type>{});
+    }
+
+    template<IsStringMap Container>
+    void typeToSchema(PropertyTree& schema, std::type_identity<Container>)
+    {
+        schema["type"]   = PropertyTreeScalar("object");
+        auto& additional = schema["additionalProperties"];
+        additional.convertToMap();
+        typeToSchema(additional, std::type_identity<typename Container::mapped_type>{});
+    }
+
+    template<IsEmptyType T>
+    void typeToSchema(PropertyTree& schema, std::type_identity<T>)
+    {
+    }
+
+    template<class T>
+    void typeToSchema(PropertyTree& schema, std::type_identity<T> tag)
+    {
+        static_cast<CustomGenerator*>(this)->typeToSchemaImpl(schema, tag);
+    }
+
+    /// When false, unknown keys of reflected structs are reported as errors (reader silently ignores them).
+    bool m_additionalProperties = true;
+
+private:
+    template<class T>
+    void itemsToSchema(PropertyTree& schema)
+    {
+        auto& items = schema["items"];
+        items.convertToMap();
+        typeToSchema(items, std::type_identity<T>{});
+    }
+};
+
+class PropertyTreeSchemaGenerator : public PropertyTreeSchemaGeneratorBase<PropertyTreeSchemaGenerator> {};
+
+}
@@ -39,10 +39,11 @@ public:
     template<class T>
     void valueToJsonUsingMeta(const T& value, PropertyTree& result)
     {
-        if (m_clearMaps)
-            result = {};
-        result.convertToMap();
-        auto& jsonMap = result.getMap();
+        PropertyTreeMap jsonMap;
+        if (!m_clearMaps) {
+            result.convertToMap();
+            jsonMap = std::move(result.getMap());
+        }
 
         auto visitor = [&value, &jsonMap, this](auto&& field) {
             const auto& fieldVal = field.get(value);
@@ -61,6 +62,7 @@ public:
         };
 
         std::apply([&visitor](auto&&... field) { ((visitor(field)), ...); }, MetaInfo::MetaFields<T>::s_fields);
+        result = PropertyTree(std::move(jsonMap));
     }
 
     void valueToJson(const HasFieldsForWrite auto& value, PropertyTree& result)
@@ -103,53 +105,49 @@ public:
 
     void valueToJson(const NonAssociative auto& container, PropertyTree& result)
     {
-        result = {};
-        result.convertToList();
-        result.getList().resize(std::size(container));
-        size_t i = 0;
-        for (const auto& value : container) {
-            PropertyTree& child = result.getList()[i++];
-            valueToJson(value, child);
-        }
+        PropertyTreeList list(std::size(container));
+        size_t           i = 0;
+        for (const auto& value : container)
+            valueToJson(value, list[i++]);
+        result = PropertyTree(std::move(list));
     }
 
     void valueToJson(const IsStdOptional auto& container, PropertyTree& result)
     {
-        result = {};
-        result.convertToList();
-        if (!container.has_value())
-            return;
-
-        result.getList().resize(1);
-
-        PropertyTree& child = result.getList()[0];
-        valueToJson(container.value(), child);
+        PropertyTreeList list;
+        if (container.has_value())
+            valueToJson(container.value(), list.emplace_back());
+        result = PropertyTree(std::move(list));
     }
 
     void valueToJson(const IsMap auto& container, PropertyTree& result)
     {
-        result = {};
-        result.convertToList();
+        PropertyTreeList list;
+        list.reserve(std::size(container));
         for (const auto& [key, value] : container) {
-            PropertyTree pair;
+            PropertyTreeMap pair;
             valueToJson(key, pair["key"]);
             valueToJson(value, pair["value"]);
-            result.append(std::move(pair));
+            list.emplace_back(std::move(pair));
         }
+        result = PropertyTree(std::move(list));
     }
 
     void valueToJson(const IsStringMap auto& container, PropertyTree& result)
     {
-        if (m_clearMaps)
-            result = {};
-        result.convertToMap();
+        PropertyTreeMap map;
+        if (!m_clearMaps) {
+            result.convertToMap();
+            map = std::move(result.getMap());
+        }
         for (const auto& [key, value] : container) {
             PropertyTree childKey;
             valueToJson(key, childKey);
             assert(childKey.isScalar() && childKey.getScalar().isString());
 
-            valueToJson(value, result[childKey.getScalar().toString()]);
+            valueToJson(value, map[childKey.getScalar().toStringView()]);
         }
+        result = PropertyTree(std::move(map));
     }
     void valueToJson(const IsEmptyType auto& container, PropertyTree& result)
     {
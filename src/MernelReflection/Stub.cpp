@@ -1,5 +1,8 @@
 #include "EnumTraitsMacro.hpp"
 #include "MetaInfoMacro.hpp"
 
+#include "JsonCursorReader.hpp"
+#include "JsonTextWriter.hpp"
 #include "PropertyTreeReader.hpp"
+#include "PropertyTreeSchemaGenerator.hpp"
 #include "PropertyTreeWriter.hpp"
@@ -0,0 +1,16 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace Mernel {
+
+/// Number of global operator new calls since program start; counted by replacement operator new in AllocationCounter.cpp.
+/// rapidjson allocates its pools with malloc, so those are not counted on either baseline or current paths.
+size_t getAllocationCount() noexcept;
+
+}
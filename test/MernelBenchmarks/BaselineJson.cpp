@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "BaselineJson.hpp"
+
+#include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace Mernel::Baseline {
+
+namespace {
+
+using Allocator = rapidjson::Document::AllocatorType;
+using Value     = rapidjson::Value;
+
+class JsonStreamOut {
+public:
+    JsonStreamOut(std::string& output)
+        : m_output(output)
+    {}
+
+    char   Peek() const { return 0; }
+    char   Take() { return 0; }
+    size_t Tell() const { return 0; }
+
+    void Put(char c) { m_output += c; }
+
+    char*  PutBegin() { return nullptr; }
+    size_t PutEnd(char*) { return 0; }
+
+private:
+    std::string& m_output;
+};
+
+struct DumpParams {
+    int    m_indentWidth    = 4;
+    size_t m_smallArraySize = 10;
+    bool   m_quoteKeys      = true;
+    bool   m_quoteValues    = true;
+    bool   m_escapeStrings  = true;
+    bool   m_compactArrays  = true;
+    bool   m_compactMaps    = true;
+};
+
+inline char toHex(uint8_t c)
+{
+    return (c <= 9) ? '0' + c : 'a' + c - 10;
+}
+
+void printJsonString(std::ostream& os, const std::string& value, bool addQuotes, bool escapeString)
+{
+    if (addQuotes)
+        os << '"';
+    if (escapeString) {
+        for (char c : value) {
+            uint8_t byte = c;
+            if (byte < 0x20) {
+                os << "\\u00" << toHex(byte / 16) << toHex(byte % 16);
+            } else if (byte == '\\') {
+                os << "\\\\";
+            } else {
+                os << c;
+            }
+        }
+    } else {
+        os << value;
+    }
+    if (addQuotes)
+        os << '"';
+}
+
+void printScalar(std::ostream& os, const Scalar& scalar, bool addQuotes, bool escapeString)
+{
+    if (const auto* bval = std::get_if<bool>(&scalar)) {
+        os << (*bval ? "true" : "false");
+        return;
+    }
+    if (const auto* ival = std::get_if<int64_t>(&scalar)) {
+        os << *ival;
+        return;
+    }
+    if (const auto* dval = std::get_if<double>(&scalar)) {
+        os << *dval;
+        if (int(*dval) == *dval)
+            os << ".0";
+        return;
+    }
+    if (const auto* sval = std::get_if<std::string>(&scalar)) {
+        printJsonString(os, *sval, addQuotes, escapeString);
+        return;
+    }
+    os << "null";
+}
+
+bool isContainer(const Tree& tree)
+{
+    return std::holds_alternative<List>(tree.m_data) || std::holds_alternative<Map>(tree.m_data);
+}
+
+void dump(std::ostream& stream, const Tree& tree, const DumpParams& params, int level)
+{
+    auto checkFlatList = [&params](const List& list) -> bool {
+        if (!params.m_compactArrays)
+            return false;
+        for (const auto& child : list) {
+            if (isContainer(child))
+                return false;
+        }
+        return true;
+    };
+    auto checkFlatMap = [&checkFlatList, &params](const Map& map) -> bool {
+        if (!params.m_compactMaps)
+            return false;
+        for (const auto& [key, child] : map) {
+            if (const auto* list = std::get_if<List>(&child.m_data)) {
+                if (list->size() > params.m_smallArraySize || !checkFlatList(*list))
+                    return false;
+            }
+            if (std::holds_alternative<Map>(child.m_data))
+                return false;
+        }
+        return true;
+    };
+    const std::string padBase((level) *params.m_indentWidth, ' ');
+    const std::string padNext((level + 1) * params.m_indentWidth, ' ');
+
+    if (const auto* list = std::get_if<List>(&tree.m_data)) {
+        const bool isFlatList = checkFlatList(*list);
+        stream << padBase << '[' << (isFlatList ? "" : "\n");
+        for (size_t index = 0, count = list->size(); const auto& child : *list) {
+            dump(stream, child, params, isFlatList ? 0 : level + 1);
+            if (index < count - 1)
+                stream << ", ";
+            if (!isFlatList)
+                stream << '\n';
+            index++;
+        }
+        stream << (isFlatList ? "" : padBase) << ']';
+        return;
+    }
+    if (const auto* map = std::get_if<Map>(&tree.m_data)) {
+        const bool isFlatMap = checkFlatMap(*map);
+        stream << padBase << '{' << (isFlatMap ? "" : "\n");
+        for (size_t index = 0, count = map->size(); const auto& [key, child] : *map) {
+            const bool simpleValue = isFlatMap || !isContainer(child);
+            if (!isFlatMap)
+                stream << padNext;
+            printJsonString(stream, key, params.m_quoteKeys, params.m_escapeStrings);
+            stream << ": " << (simpleValue ? "" : "\n");
+            dump(stream, child, params, simpleValue ? 0 : level + 2);
+            if (index < count - 1)
+                stream << ", ";
+            if (!isFlatMap)
+                stream << '\n';
+            index++;
+        }
+        stream << (isFlatMap ? "" : padBase) << '}';
+        return;
+    }
+    stream << padBase;
+    if (const auto* scalar = std::get_if<Scalar>(&tree.m_data))
+        printScalar(stream, *scalar, params.m_quoteValues, params.m_escapeStrings);
+    else
+        stream << "null";
+}
+
+void jsonToTree(Tree& data, Value& input)
+{
+    switch (input.GetType()) {
+        case rapidjson::kNullType:
+        {
+            data = {};
+        } break;
+        case rapidjson::kFalseType:
+        {
+            data.m_data = Scalar(false);
+        } break;
+        case rapidjson::kTrueType:
+        {
+            data.m_data = Scalar(true);
+        } break;
+        case rapidjson::kObjectType:
+        {
+            auto& m = data.m_data.emplace<Map>();
+            for (auto keyIt = input.MemberBegin(); keyIt != input.MemberEnd(); ++keyIt) {
+                std::string key(keyIt->name.GetString(), keyIt->name.GetStringLength());
+                jsonToTree(m[key], keyIt->value);
+            }
+        } break;
+        case rapidjson::kArrayType:
+        {
+            auto& l = data.m_data.emplace<List>();
+            l.resize(std::distance(input.Begin(), input.End()));
+            size_t index = 0;
+            for (auto nodeIt = input.Begin(); nodeIt != input.End(); ++nodeIt) {
+                jsonToTree(l[index++], *nodeIt);
+            }
+        } break;
+        case rapidjson::kStringType:
+        {
+            std::string inputString(input.GetString(), input.GetStringLength());
+            data.m_data = Scalar(std::move(inputString));
+        } break;
+        case rapidjson::kNumberType:
+        {
+            if (input.IsDouble())
+                data.m_data = Scalar(input.GetDouble());
+            else if (input.IsInt())
+                data.m_data = Scalar(std::int64_t(input.GetInt()));
+            else if (input.IsInt64())
+                data.m_data = Scalar(std::int64_t(input.GetInt64()));
+            else if (input.IsUint())
+                data.m_data = Scalar(std::int64_t(input.GetUint()));
+            else if (input.IsUint64())
+                data.m_data = Scalar(std::int64_t(input.GetUint64()));
+        } break;
+    }
+}
+
+void treeToJson(const Tree& data, Value& json, Allocator& allocator)
+{
+    if (const auto* list = std::get_if<List>(&data.m_data)) {
+        json.SetArray();
+        for (const Tree& child : *list) {
+            Value tempValue;
+            treeToJson(child, tempValue, allocator);
+            json.PushBack(tempValue, allocator);
+        }
+    } else if (const auto* map = std::get_if<Map>(&data.m_data)) {
+        json.SetObject();
+        for (const auto& p : *map) {
+            Value tempValue;
+            treeToJson(p.second, tempValue, allocator);
+            json.AddMember(p.first.c_str(), allocator, tempValue, allocator);
+        }
+    } else if (const auto* scalar = std::get_if<Scalar>(&data.m_data)) {
+        if (const auto* b = std::get_if<bool>(scalar))
+            json.SetBool(*b);
+        if (const auto* i = std::get_if<int64_t>(scalar))
+            json.SetInt64(*i);
+        if (const auto* d = std::get_if<double>(scalar))
+            json.SetDouble(*d);
+        if (const auto* s = std::get_if<std::string>(scalar)) {
+            const std::string copy = *s;
+            json.SetString(copy.data(), static_cast<rapidjson::SizeType>(copy.size()), allocator);
+        }
+    }
+}
+
+}
+
+Tree readJson(const std::string& buffer) noexcept(false)
+{
+    rapidjson::Document input;
+    const char*         dataPtr = buffer.data();
+    if (buffer.starts_with(std::string_view("\xef\xbb\xbf", 3)))
+        dataPtr += 3;
+
+    auto& res = input.Parse<0>(dataPtr);
+    if (res.HasParseError() || (!input.IsObject() && !input.IsArray()))
+        throw std::runtime_error("Failed to read JSON");
+
+    Tree result;
+    jsonToTree(result, input);
+    return result;
+}
+
+std::string writeJson(const Tree& tree) noexcept(false)
+{
+    if (std::holds_alternative<std::monostate>(tree.m_data))
+        throw std::runtime_error("Failed to write JSON");
+
+    rapidjson::Document json;
+    treeToJson(tree, json, json.GetAllocator());
+
+    std::string                      buffer;
+    JsonStreamOut                    outStream(buffer);
+    rapidjson::Writer<JsonStreamOut> writer(outStream);
+    json.Accept(writer);
+    return buffer;
+}
+
+std::string writeReadableJson(const Tree& tree) noexcept(false)
+{
+    std::ostringstream os;
+    dump(os, tree, DumpParams{}, 0);
+    os << '\n';
+    return os.str();
+}
+
+void mergePatch(Tree& dest, const Tree& source) noexcept(false)
+{
+    const auto* sourceMap = std::get_if<Map>(&source.m_data);
+    if (!sourceMap) {
+        dest = source;
+        return;
+    }
+    if (std::holds_alternative<std::monostate>(dest.m_data))
+        dest.m_data = Map{};
+
+    auto* destMap = std::get_if<Map>(&dest.m_data);
+    if (!destMap) {
+        dest = {};
+        return;
+    }
+    for (const auto& [key, value] : *sourceMap) {
+        if (std::holds_alternative<std::monostate>(value.m_data))
+            destMap->erase(key);
+        else
+            mergePatch((*destMap)[key], value);
+    }
+}
+
+void removeEqualValues(Tree& one, Tree& two) noexcept(false)
+{
+    if (one == two) {
+        one = {};
+        two = {};
+        return;
+    }
+
+    if (auto* oneMap = std::get_if<Map>(&one.m_data)) {
+        auto* twoMap = std::get_if<Map>(&two.m_data);
+        if (!twoMap)
+            return;
+
+        std::vector<std::string> commonKeys;
+        for (auto&& [key, value] : *oneMap) {
+            if (!twoMap->contains(key))
+                continue;
+            commonKeys.push_back(key);
+        }
+        for (const auto& key : commonKeys) {
+            auto& oneMapValue = (*oneMap)[key];
+            auto& twoMapValue = (*twoMap)[key];
+            removeEqualValues(oneMapValue, twoMapValue);
+            if (std::holds_alternative<std::monostate>(oneMapValue.m_data) && std::holds_alternative<std::monostate>(twoMapValue.m_data)) {
+                oneMap->erase(key);
+                twoMap->erase(key);
+            }
+        }
+    }
+    if (auto* oneList = std::get_if<List>(&one.m_data)) {
+        auto* twoList = std::get_if<List>(&two.m_data);
+        if (!twoList)
+            return;
+
+        const auto minSize = std::min(oneList->size(), twoList->size());
+        for (size_t i = 0; i < minSize; ++i)
+            removeEqualValues((*oneList)[i], (*twoList)[i]);
+    }
+}
+
+}
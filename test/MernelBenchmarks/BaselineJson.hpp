@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <variant>
+#include <vector>
+
+/**
+ * Reference point for benchmarks: PropertyTree layout and JSON conversion as they were before the performance work.
+ * Nodes are std::map / std::vector / variant scalar holding std::string;
+ * reading parses whole rapidjson Document with Parse<0> and copies it into the tree,
+ * writing copies the tree into a Document and writes it one character at a time,
+ * pretty output is PropertyTree::printReadableJson over std::ostringstream.
+ */
+namespace Mernel::Baseline {
+
+struct Tree;
+
+using Scalar = std::variant<std::monostate, bool, int64_t, double, std::string>;
+using List   = std::vector<Tree>;
+using Map    = std::map<std::string, Tree>;
+
+struct Tree {
+    std::variant<std::monostate, Scalar, List, Map> m_data;
+
+    bool operator==(const Tree&) const = default;
+};
+
+/// Throws std::runtime_error on malformed input.
+Tree        readJson(const std::string& buffer) noexcept(false);
+std::string writeJson(const Tree& tree) noexcept(false);
+std::string writeReadableJson(const Tree& tree) noexcept(false);
+
+/// PropertyTree::mergePatch: per-key lookup, insert and erase, values copied from the patch.
+void mergePatch(Tree& dest, const Tree& source) noexcept(false);
+/// PropertyTree::removeEqualValues: deep operator== at every level, per-key lookups and erase.
+void removeEqualValues(Tree& one, Tree& two) noexcept(false);
+
+}
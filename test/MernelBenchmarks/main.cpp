@@ -0,0 +1,674 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "AllocationCounter.hpp"
+#include "BaselineJson.hpp"
+#include "../MernelTests/TestTypes.hpp"
+
+#include "MernelPlatform/ByteOrderStream.hpp"
+#include "MernelPlatform/FileFormatBinaryTree.hpp"
+#include "MernelPlatform/FileFormatJson.hpp"
+#include "MernelPlatform/FileFormatJsonLines.hpp"
+#include "MernelPlatform/FileFormatJsonView.hpp"
+#include "MernelPlatform/FileIOUtils.hpp"
+#include "MernelPlatform/MappedFile.hpp"
+#include "MernelPlatform/PropertyTreeArena.hpp"
+#include "MernelPlatform/PropertyTreePath.hpp"
+#include "MernelPlatform/PropertyTreeSchema.hpp"
+#include "MernelExecution/ParallelExecutor.hpp"
+#include "MernelExecution/TaskQueue.hpp"
+#include "MernelReflection/JsonCursorReader.hpp"
+#include "MernelReflection/JsonTextWriter.hpp"
+#include "MernelReflection/PropertyTreeReader.hpp"
+#include "MernelReflection/PropertyTreeWriter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+namespace Mernel {
+
+namespace {
+
+const int s_runs = 5;
+
+struct Measure {
+    double m_ms          = 0;
+    size_t m_allocations = 0;
+};
+
+template<class Callback>
+Measure measureOnce(Callback&& callback)
+{
+    const size_t allocations = getAllocationCount();
+    const auto   start       = std::chrono::steady_clock::now();
+    callback();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return Measure{ ms, getAllocationCount() - allocations };
+}
+
+/// Best of several runs; allocations are counted for the best run.
+template<class Callback>
+Measure measure(Callback&& callback)
+{
+    Measure best;
+    for (int i = 0; i < s_runs; ++i) {
+        const Measure current = measureOnce(callback);
+        if (i == 0 || current.m_ms < best.m_ms)
+            best = current;
+    }
+    return best;
+}
+
+/// Same as measure(), but setup() runs before each callback(state) call and is not timed.
+template<class Setup, class Callback>
+Measure measurePrepared(Setup&& setup, Callback&& callback)
+{
+    Measure best;
+    for (int i = 0; i < s_runs; ++i) {
+        auto          state   = setup();
+        const Measure current = measureOnce([&] { callback(state); });
+        if (i == 0 || current.m_ms < best.m_ms)
+            best = current;
+    }
+    return best;
+}
+
+void report(const std::string& name, const Measure& result, size_t bytes = 0)
+{
+    std::cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(2) << std::setw(10) << result.m_ms << " ms";
+    if (bytes)
+        std::cout << std::setw(10) << (bytes / 1048576.0) / (result.m_ms / 1000.0) << " MB/s";
+    std::cout << std::setw(12) << result.m_allocations << " allocs\n";
+}
+
+/// Times creation and destruction of the object returned by load() separately, best of several runs each.
+template<class Load>
+void reportLoadFree(const std::string& name, Load&& load, size_t bytes)
+{
+    using State = decltype(load());
+    Measure loadBest, freeBest;
+    for (int i = 0; i < s_runs; ++i) {
+        std::optional<State> state;
+        const Measure        loadTime = measureOnce([&] { state.emplace(load()); });
+        const Measure        freeTime = measureOnce([&] { state.reset(); });
+        if (i == 0 || loadTime.m_ms < loadBest.m_ms)
+            loadBest = loadTime;
+        if (i == 0 || freeTime.m_ms < freeBest.m_ms)
+            freeBest = freeTime;
+    }
+    report(name + ": load", loadBest, bytes);
+    report(name + ": free", freeBest);
+}
+
+std::string makeDocument(int size)
+{
+    std::string result = "{\"items\":[";
+    for (int i = 0; i < size; ++i) {
+        if (i)
+            result += ",";
+        result += "{\"id\":" + std::to_string(i) + ",\"name\":\"a string longer than inline storage " + std::to_string(i)
+                  + "\",\"weights\":[1.5,2.25,-3],\"flag\":true,\"extra\":null,\"tag\":\"x\"}";
+    }
+    return result + "]}";
+}
+
+std::string makeRootMapDocument(int size)
+{
+    std::string result = "{";
+    for (int i = 0; i < size; ++i) {
+        if (i)
+            result += ",";
+        result += "\"key" + std::to_string(i) + "\":{\"id\":" + std::to_string(i) + ",\"name\":\"a string longer than inline storage\",\"weights\":[1.5,2.25,-3]}";
+    }
+    return result + "}";
+}
+
+void benchmarkTree(const std::string& document)
+{
+    std::cout << "-- PropertyTree load/free\n";
+    reportLoadFree("baseline", [&] { return Baseline::readJson(document); }, document.size());
+    reportLoadFree("heap", [&] { return readJsonFromBuffer(document); }, document.size());
+
+    struct ArenaTree {
+        std::unique_ptr<PropertyTreeArena> m_arena = std::make_unique<PropertyTreeArena>();
+        PropertyTree                        m_tree;
+    };
+    auto loadArena = [&] {
+        ArenaTree                result;
+        PropertyTreeArena::Scope scope(*result.m_arena);
+        result.m_tree = readJsonFromBuffer(document);
+        return result;
+    };
+    reportLoadFree("arena", loadArena, document.size());
+}
+
+void benchmarkParse(const std::string& document)
+{
+    std::cout << "-- JSON parse\n";
+    report("baseline: parse", measure([&] { Baseline::Tree tree = Baseline::readJson(document); }), document.size());
+    report("copying parse", measure([&] { PropertyTree tree = readJsonFromBuffer(document); }), document.size());
+
+    JsonReadParams params;
+    std::string    buffer;
+    report("in-situ parse (includes buffer copy)", measure([&] {
+               buffer            = document;
+               PropertyTree tree = readJsonFromMutableBuffer(buffer);
+           }),
+           document.size());
+    params.m_borrowStrings = true;
+    report("in-situ parse, borrowed strings", measure([&] {
+               buffer            = document;
+               PropertyTree tree = readJsonFromMutableBuffer(buffer, params);
+           }),
+           document.size());
+
+    const std::string pretty = writeJsonToBuffer(readJsonFromBuffer(document), true);
+    report("baseline: parse pretty document", measure([&] { Baseline::Tree tree = Baseline::readJson(pretty); }), pretty.size());
+    report("copying parse, pretty document", measure([&] { PropertyTree tree = readJsonFromBuffer(pretty); }), pretty.size());
+
+    params              = {};
+    params.m_internKeys = true;
+    report("copying parse, interned keys", measure([&] { PropertyTree tree = readJsonFromBuffer(document, params); }), document.size());
+
+    params                 = {};
+    params.m_borrowStrings = true;
+    report("arena parse, borrowed strings", measure([&] {
+               PropertyTreeArena arena;
+               PropertyTree      tree;
+               {
+                   PropertyTreeArena::Scope scope(arena);
+                   tree = readJsonFromBuffer(document, params);
+               }
+           }),
+           document.size());
+}
+
+void benchmarkParallelParse()
+{
+    std::cout << "-- JSON parse, large root map\n";
+    const std::string document = makeRootMapDocument(200000);
+
+    report("baseline: parse", measure([&] { Baseline::Tree tree = Baseline::readJson(document); }), document.size());
+    report("copying parse", measure([&] { PropertyTree tree = readJsonFromBuffer(document); }), document.size());
+
+    const unsigned   threads = std::max(2u, std::thread::hardware_concurrency());
+    ParallelExecutor exec(threads);
+    TaskQueue        queue;
+    JsonReadParams   params;
+    params.m_parallelRunner = [&](std::vector<std::function<void()>> tasks) { execTasks(queue, exec, std::move(tasks)); };
+    report("copying parse, " + std::to_string(threads) + " threads", measure([&] { PropertyTree tree = readJsonFromBuffer(document, params); }), document.size());
+}
+
+void benchmarkJsonLines()
+{
+    std::cout << "-- JSON Lines, 200k records\n";
+    std::string lines;
+    for (int i = 0; i < 200000; ++i)
+        lines += "{\"id\":" + std::to_string(i) + ",\"name\":\"a string longer than inline storage\",\"weights\":[1.5,2.25,-3]}\n";
+
+    report("baseline: getline + parse", measure([&] {
+               std::istringstream is(lines);
+               std::string        line;
+               while (std::getline(is, line))
+                   Baseline::Tree record = Baseline::readJson(line);
+           }),
+           lines.size());
+    report("JsonLinesReader::next", measure([&] {
+               std::istringstream is(lines);
+               JsonLinesReader    reader(is);
+               PropertyTree       record;
+               while (reader.next(record)) {
+               }
+           }),
+           lines.size());
+
+    const PropertyTree record = readJsonFromBuffer(lines.substr(0, lines.find('\n')));
+    report("JsonLinesWriter", measure([&] {
+               std::ostringstream os;
+               JsonLinesWriter    writer(os);
+               for (int i = 0; i < 200000; ++i)
+                   writer.write(record);
+               writer.flush();
+           }),
+           lines.size());
+}
+
+void benchmarkView(const std::string& document)
+{
+    std::cout << "-- Read one field of a document\n";
+    const size_t last = 199999;
+    report("baseline: parse, then lookup", measure([&] {
+               const Baseline::Tree tree = Baseline::readJson(document);
+               const auto&          item = std::get<Baseline::List>(std::get<Baseline::Map>(tree.m_data).at("items").m_data)[last];
+               (void) std::get<Baseline::Map>(item.m_data).at("name");
+           }),
+           document.size());
+    report("JsonDocument view", measure([&] {
+               JsonDocument jsonDocument(document);
+               (void) jsonDocument.root()["items"][last]["name"].getScalar();
+           }),
+           document.size());
+
+    // view keeps pointer to its index, so repeated access does not go through the document cache.
+    JsonDocument   jsonDocument(document);
+    const JsonView items = jsonDocument.root()["items"];
+    report("JsonDocument view, access every item", measure([&] {
+               for (size_t i = 0; i <= last; ++i)
+                   (void) items[i];
+           }));
+}
+
+void benchmarkBinaryTree(const std::string& document)
+{
+    std::cout << "-- Binary tree snapshot\n";
+    ByteOrderBuffer buffer;
+    writeBinaryTreeToBuffer(buffer, readJsonFromBuffer(document));
+    const std::span<const uint8_t> data(buffer.begin(), buffer.end());
+    std::cout << "binary size: " << data.size() << " bytes\n";
+
+    report("baseline: parse JSON", measure([&] { Baseline::Tree tree = Baseline::readJson(document); }), document.size());
+    report("read binary tree", measure([&] { PropertyTree tree = readBinaryTreeFromBuffer(data); }), data.size());
+    report("binary view, one lookup", measure([&] { (void) BinaryTreeView::root(data)["items"][199999]["name"].getScalar(); }));
+
+    const std_path  path = std::filesystem::temp_directory_path() / "mernel_benchmark_tree.bin";
+    ByteArrayHolder holder;
+    holder.resize(data.size());
+    std::memcpy(holder.data(), data.data(), data.size());
+    writeFileFromHolder(path, holder);
+    report("baseline: read file, one lookup", measure([&] {
+               const ByteArrayHolder file = readFileIntoHolder(path);
+               (void) BinaryTreeView::root(std::span<const uint8_t>(file.data(), file.size()))["items"][199999]["name"].getScalar();
+           }));
+    report("mapped file, one lookup", measure([&] {
+               MappedFile file(path);
+               (void) BinaryTreeView::root(file.data())["items"][199999]["name"].getScalar();
+           }));
+    std::filesystem::remove(path);
+}
+
+void benchmarkCopy(const std::string& document)
+{
+    std::cout << "-- Copy of a loaded document\n";
+    const Baseline::Tree baselineTree = Baseline::readJson(document);
+    const PropertyTree   tree         = readJsonFromBuffer(document);
+    report("baseline: copy + free", measure([&] { Baseline::Tree copy = baselineTree; }));
+    report("copy + free", measure([&] { PropertyTree copy = tree; }));
+
+    PropertyTree shared = tree;
+    report("share()", measureOnce([&] { shared.share(); }));
+    report("shared: copy + free", measure([&] { PropertyTree copy = shared; }));
+    report("shared: copy, change one item, free", measure([&] {
+               PropertyTree copy = shared;
+               copy["items"].getList()[150000]["id"] = PropertyTreeScalar(-1);
+           }));
+}
+
+void benchmarkPath(const std::string& document)
+{
+    std::cout << "-- 1M lookups of /items/<index>/name\n";
+    const int            lookups      = 1000000;
+    const Baseline::Tree baselineTree = Baseline::readJson(document);
+    const PropertyTree   tree         = readJsonFromBuffer(document);
+    volatile size_t      found        = 0;
+
+    report("baseline: map::at + list index", measure([&] {
+               for (int i = 0; i < lookups; ++i) {
+                   const auto& root  = std::get<Baseline::Map>(baselineTree.m_data);
+                   const auto& items = std::get<Baseline::List>(root.at("items").m_data);
+                   found             = found + std::get<Baseline::Map>(items[(i % 1000) * 199].m_data).count("name");
+               }
+           }));
+
+    report("operator[] chain", measure([&] {
+               for (int i = 0; i < lookups; ++i)
+                   found = found + tree["items"].getList()[(i % 1000) * 199].contains("name");
+           }));
+
+    std::vector<PropertyTreePath> paths;
+    for (int i = 0; i < 1000; ++i)
+        paths.push_back(PropertyTreePath::fromPointer("/items/" + std::to_string(i * 199) + "/name"));
+    report("compiled PropertyTreePath", measure([&] {
+               for (int i = 0; i < lookups; ++i)
+                   found = found + (paths[i % 1000].resolve(tree) != nullptr);
+           }));
+}
+
+void benchmarkSchema(const std::string& document)
+{
+    std::cout << "-- Schema validation\n";
+    const PropertyTree       tree   = readJsonFromBuffer(document);
+    const PropertyTreeSchema schema = PropertyTreeSchema::compile(readJsonFromBuffer(
+        R"({"type":"object","required":["items"],"properties":{"items":{"type":"array","items":{"type":"object",)"
+        R"("required":["id","name"],"properties":{"id":{"type":"integer","minimum":0},"name":{"type":"string","maxLength":64},)"
+        R"("weights":{"type":"array","items":{"type":"number"}},"flag":{"type":"boolean"},"tag":{"enum":["x","y"]}}}}}})"));
+    report("copying parse", measure([&] { PropertyTree parsed = readJsonFromBuffer(document); }), document.size());
+    report("validate parsed tree", measure([&] { (void) schema.isValid(tree); }), document.size());
+}
+
+void benchmarkRemoveEqualValues(const std::string& document)
+{
+    std::cout << "-- removeEqualValues, documents differing in one entry\n";
+    std::string changed = document;
+    const auto  pos     = changed.find("\"id\":150000,");
+    changed.replace(pos, 12, "\"id\":-1,");
+
+    const Baseline::Tree baselineOne = Baseline::readJson(document);
+    const Baseline::Tree baselineTwo = Baseline::readJson(changed);
+    report("baseline", measurePrepared([&] { return std::pair(baselineOne, baselineTwo); }, [](auto& trees) {
+               Baseline::removeEqualValues(trees.first, trees.second);
+           }));
+
+    const PropertyTree one = readJsonFromBuffer(document);
+    const PropertyTree two = readJsonFromBuffer(changed);
+    report("removeEqualValues", measurePrepared([&] { return std::pair(one, two); }, [](auto& trees) {
+               PropertyTree::removeEqualValues(trees.first, trees.second);
+           }));
+    report("hash", measure([&] { (void) one.hash(); }));
+
+    // unchanged subtrees of a copy stay shared with the original, so they are skipped without traversal.
+    PropertyTree shared = one;
+    shared.share();
+    const auto makeChangedCopy = [&shared] {
+        PropertyTree copy                     = shared;
+        copy["items"].getList()[150000]["id"] = PropertyTreeScalar(-1);
+        return std::pair(shared, std::move(copy));
+    };
+    report("shared copy, one item changed", measurePrepared(makeChangedCopy, [](auto& trees) {
+               PropertyTree::removeEqualValues(trees.first, trees.second);
+           }));
+}
+
+void benchmarkDiff()
+{
+    std::cout << "-- diff / mergePatch, root maps differing in one entry\n";
+    const std::string document = makeRootMapDocument(200000);
+    std::string       changed  = document;
+    const auto        pos      = changed.find("\"id\":150000,");
+    changed.replace(pos, 12, "\"id\":-1,");
+
+    const PropertyTree from  = readJsonFromBuffer(document);
+    const PropertyTree to    = readJsonFromBuffer(changed);
+    const PropertyTree patch = PropertyTree::diff(from, to);
+    report("diff", measure([&] { PropertyTree result = PropertyTree::diff(from, to); }));
+
+    const Baseline::Tree baselineFrom  = Baseline::readJson(document);
+    const Baseline::Tree baselineTo    = Baseline::readJson(changed);
+    const Baseline::Tree baselinePatch = Baseline::readJson(writeJsonToBuffer(patch));
+    report("baseline: apply diff", measurePrepared([&] { return baselineFrom; }, [&](Baseline::Tree& target) {
+               Baseline::mergePatch(target, baselinePatch);
+           }));
+    report("apply diff", measurePrepared([&] { return from; }, [&](PropertyTree& target) {
+               PropertyTree::mergePatch(target, patch);
+           }));
+
+    // whole document as a patch, so copying or moving the patch contents dominates.
+    report("baseline: apply full patch", measurePrepared([&] { return baselineTo; }, [&](Baseline::Tree& target) {
+               Baseline::mergePatch(target, baselineFrom);
+           }));
+    report("apply full patch, copying", measurePrepared([&] { return to; }, [&](PropertyTree& target) {
+               PropertyTree::mergePatch(target, from);
+           }));
+    report("apply full patch, moving", measurePrepared([&] { return std::pair(to, from); }, [](auto& trees) {
+               PropertyTree::mergePatch(trees.first, std::move(trees.second));
+           }));
+}
+
+void benchmarkNumbers()
+{
+    std::cout << "-- Numeric export, 1M doubles\n";
+    std::string document = "[";
+    for (int i = 0; i < 1000000; ++i)
+        document += (i ? "," : "") + std::to_string(i * 0.37 - 1000.0);
+    document += "]";
+
+    const Baseline::Tree baselineTree = Baseline::readJson(document);
+    const PropertyTree   tree         = readJsonFromBuffer(document);
+    report("baseline: compact", measure([&] { std::string out = Baseline::writeJson(baselineTree); }));
+    report("compact", measure([&] { std::string out = writeJsonToBuffer(tree); }));
+    report("baseline: pretty", measure([&] { std::string out = Baseline::writeReadableJson(baselineTree); }));
+    report("pretty", measure([&] { std::string out = writeJsonToBuffer(tree, true); }));
+}
+
+void benchmarkReflectionRead()
+{
+    std::cout << "-- Read reflected struct from JSON text\n";
+    PropertyTree valueTree;
+    Reflection::PropertyTreeWriter().valueToJson(TestData::makeOuter(100000), valueTree);
+    const std::string buffer = writeJsonToBuffer(valueTree);
+
+    report("text -> PropertyTree -> struct", measure([&] {
+               TestData::Outer value;
+               Reflection::PropertyTreeReader().jsonToValue(readJsonFromBuffer(buffer), value);
+           }),
+           buffer.size());
+    report("text -> struct (JsonCursorReader)", measure([&] {
+               TestData::Outer value;
+               Reflection::JsonCursorReader().readFromBuffer(buffer, value);
+           }),
+           buffer.size());
+}
+
+void benchmarkWrite(const std::string& document)
+{
+    std::cout << "-- JSON write\n";
+    const Baseline::Tree baselineTree = Baseline::readJson(document);
+    const PropertyTree   tree         = readJsonFromBuffer(document);
+    report("baseline: write tree to buffer", measure([&] { std::string out = Baseline::writeJson(baselineTree); }), document.size());
+    report("write tree to buffer", measure([&] { std::string out = writeJsonToBuffer(tree); }), document.size());
+    report("write tree to stream", measure([&] {
+               std::ostringstream os;
+               writeJsonToStream(os, tree);
+           }),
+           document.size());
+
+    report("baseline: write pretty", measure([&] { std::string out = Baseline::writeReadableJson(baselineTree); }), document.size());
+    report("write pretty", measure([&] { std::string out = writeJsonToBuffer(tree, true); }), document.size());
+    if (Baseline::writeReadableJson(baselineTree) != writeJsonToBuffer(tree, true))
+        std::cout << "pretty output differs from baseline!\n";
+
+    const TestData::Outer value = TestData::makeOuter(100000);
+    report("struct -> PropertyTree -> text", measure([&] {
+               PropertyTree valueTree;
+               Reflection::PropertyTreeWriter().valueToJson(value, valueTree);
+               std::string out = writeJsonToBuffer(valueTree);
+           }));
+    report("struct -> text (JsonTextWriter)", measure([&] { std::string out = Reflection::JsonTextWriter().writeToBuffer(value); }));
+}
+
+/// Per-element streaming is what std::vector serialization did before the bulk path.
+template<class T>
+void benchmarkBulk(uint_fast8_t mask, const char* name)
+{
+    const std::vector<T> values(1 << 22, T(7));
+    std::vector<T>       result;
+    ByteOrderBuffer      buffer;
+    report(std::string("baseline: per-element ") + name, measure([&] {
+               buffer.reset();
+               ByteOrderDataStreamWriter writer(buffer, mask);
+               writer.writeSize(values.size());
+               for (const T& element : values)
+                   writer << element;
+               ByteOrderDataStreamReader reader(buffer, mask);
+               result.resize(reader.readSize());
+               for (T& element : result)
+                   reader >> element;
+           }),
+           values.size() * sizeof(T) * 2);
+    report(std::string("bulk ") + name, measure([&] {
+               buffer.reset();
+               ByteOrderDataStreamWriter writer(buffer, mask);
+               writer << values;
+               ByteOrderDataStreamReader reader(buffer, mask);
+               reader >> result;
+           }),
+           values.size() * sizeof(T) * 2);
+}
+
+void benchmarkByteOrderArrays()
+{
+    std::cout << "-- ByteOrderStream arrays\n";
+    benchmarkBulk<uint16_t>(ByteOrderDataStream::s_littleEndian, "uint16 LE");
+    benchmarkBulk<uint16_t>(ByteOrderDataStream::s_bigEndian, "uint16 BE");
+    benchmarkBulk<uint32_t>(ByteOrderDataStream::s_littleEndian, "uint32 LE");
+    benchmarkBulk<uint32_t>(ByteOrderDataStream::s_bigEndian, "uint32 BE");
+    benchmarkBulk<float>(ByteOrderDataStream::s_littleEndian, "float LE");
+    benchmarkBulk<float>(ByteOrderDataStream::s_bigEndian, "float BE");
+}
+
+template<std::endian order>
+void benchmarkFixedOrder(uint_fast8_t mask, const char* name)
+{
+    constexpr uint32_t count = 1 << 22;
+    ByteOrderBuffer    buffer;
+    uint64_t           sum = 0;
+    report(std::string("baseline: runtime mask scalars ") + name, measure([&] {
+               buffer.reset();
+               ByteOrderDataStreamWriter writer(buffer, mask);
+               for (uint32_t i = 0; i < count; ++i)
+                   writer << i;
+               ByteOrderDataStreamReader reader(buffer, mask);
+               for (uint32_t i = 0; i < count; ++i)
+                   sum += reader.readScalar<uint32_t>();
+           }),
+           count * sizeof(uint32_t) * 2);
+    report(std::string("fixed order scalars ") + name, measure([&] {
+               buffer.reset();
+               ByteOrderDataStreamWriterT<order> writer(buffer);
+               for (uint32_t i = 0; i < count; ++i)
+                   writer << i;
+               ByteOrderDataStreamReaderT<order> reader(buffer);
+               for (uint32_t i = 0; i < count; ++i)
+                   sum += reader.template readScalar<uint32_t>();
+           }),
+           count * sizeof(uint32_t) * 2);
+    if (sum == 0)
+        std::cout << "unexpected checksum\n";
+}
+
+void benchmarkByteOrderScalars()
+{
+    std::cout << "-- ByteOrderStream scalars\n";
+    benchmarkFixedOrder<std::endian::little>(ByteOrderDataStream::s_littleEndian, "LE");
+    benchmarkFixedOrder<std::endian::big>(ByteOrderDataStream::s_bigEndian, "BE");
+}
+
+struct RecordFixed {
+    int32_t m_x      = 1;
+    int32_t m_y      = 2;
+    double  m_weight = 3;
+    uint8_t m_flag   = 4;
+
+    static constexpr size_t s_binarySize = 4 + 4 + 8 + 1;
+
+    void readBinary(ByteOrderReadCursor& cursor) { cursor >> m_x >> m_y >> m_weight >> m_flag; }
+    void writeBinary(ByteOrderWriteCursor& cursor) const { cursor << m_x << m_y << m_weight << m_flag; }
+};
+
+/// Same layout without s_binarySize, so every field goes through the checked stream as before.
+struct RecordChecked {
+    int32_t m_x      = 1;
+    int32_t m_y      = 2;
+    double  m_weight = 3;
+    uint8_t m_flag   = 4;
+
+    void readBinary(ByteOrderDataStreamReader& stream) { stream >> m_x >> m_y >> m_weight >> m_flag; }
+    void writeBinary(ByteOrderDataStreamWriter& stream) const { stream << m_x << m_y << m_weight << m_flag; }
+};
+
+template<class Record>
+void benchmarkRecords(const char* name)
+{
+    std::vector<Record> records(1 << 20);
+    ByteOrderBuffer     buffer;
+    report(name, measure([&] {
+               buffer.reset();
+               ByteOrderDataStreamWriter writer(buffer, ByteOrderDataStream::s_bigEndian);
+               writer << records;
+               ByteOrderDataStreamReader reader(buffer, ByteOrderDataStream::s_bigEndian);
+               reader >> records;
+           }),
+           records.size() * 17 * 2);
+}
+
+void benchmarkByteOrderRecords()
+{
+    std::cout << "-- ByteOrderStream records\n";
+    benchmarkRecords<RecordChecked>("baseline: records (checked fields)");
+    benchmarkRecords<RecordFixed>("fixed-size records (cursor)");
+}
+
+void benchmarkByteOrderViews()
+{
+    std::cout << "-- ByteOrderStream string views\n";
+    constexpr int   count = 1 << 20;
+    ByteOrderBuffer buffer;
+    {
+        ByteOrderDataStreamWriter writer(buffer, ByteOrderDataStream::s_littleEndian);
+        for (int i = 0; i < count; ++i)
+            writer << "a string longer than inline storage " + std::to_string(i);
+    }
+    size_t total = 0;
+    report("read std::string (copying)", measure([&] {
+               buffer.resetRead();
+               ByteOrderDataStreamReader reader(buffer, ByteOrderDataStream::s_littleEndian);
+               std::string               value;
+               for (int i = 0; i < count; ++i) {
+                   reader >> value;
+                   total += value.size();
+               }
+           }),
+           buffer.getSize());
+    report("read std::string_view", measure([&] {
+               buffer.resetRead();
+               ByteOrderDataStreamReader reader(buffer, ByteOrderDataStream::s_littleEndian);
+               std::string_view          value;
+               for (int i = 0; i < count; ++i) {
+                   reader >> value;
+                   total += value.size();
+               }
+           }),
+           buffer.getSize());
+    if (total == 0)
+        std::cout << "unexpected checksum\n";
+}
+
+}
+
+}
+
+int main()
+{
+    using namespace Mernel;
+    const std::string document = makeDocument(200000);
+    std::cout << "document size: " << document.size() << " bytes\n";
+
+    benchmarkTree(document);
+    benchmarkParse(document);
+    benchmarkParallelParse();
+    benchmarkJsonLines();
+    benchmarkView(document);
+    benchmarkBinaryTree(document);
+    benchmarkCopy(document);
+    benchmarkPath(document);
+    benchmarkSchema(document);
+    benchmarkRemoveEqualValues(document);
+    benchmarkDiff();
+    benchmarkNumbers();
+    benchmarkReflectionRead();
+    benchmarkWrite(document);
+    benchmarkByteOrderArrays();
+    benchmarkByteOrderScalars();
+    benchmarkByteOrderRecords();
+    benchmarkByteOrderViews();
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/FileFormatBinaryTree.hpp"
+#include "MernelPlatform/FileFormatJson.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace Mernel {
+
+namespace {
+
+const std::string s_document = R"({"a":[1,-2,2.5,"x\ny",true,false,null,9223372036854775807,-9223372036854775807],)"
+                               R"("bb":{"k":"very long string value here","a":{}},"n":-3,"e":[],"k":{"k":1}})";
+
+std::vector<uint8_t> encode(const PropertyTree& tree)
+{
+    ByteOrderBuffer buffer;
+    writeBinaryTreeToBuffer(buffer, tree);
+    return std::vector<uint8_t>(buffer.begin(), buffer.end());
+}
+
+std::vector<uint8_t> header(uint32_t rootOffset)
+{
+    return { 'M', 'P', 'T', 'B', 1, 0, 0, 0, uint8_t(rootOffset), uint8_t(rootOffset >> 8), uint8_t(rootOffset >> 16), uint8_t(rootOffset >> 24) };
+}
+
+}
+
+TEST(BinaryTreeTest, RoundTrip)
+{
+    const PropertyTree         reference = readJsonFromBuffer(s_document);
+    const std::vector<uint8_t> data      = encode(reference);
+
+    EXPECT_EQ(readBinaryTreeFromBuffer(data), reference);
+    EXPECT_EQ(BinaryTreeView::root(data).toPropertyTree(true), reference);
+
+    for (const PropertyTree& scalar : { PropertyTree(), PropertyTree(PropertyTreeScalar(3.5)), PropertyTree(PropertyTreeScalar("s")) })
+        EXPECT_EQ(readBinaryTreeFromBuffer(encode(scalar)), scalar);
+}
+
+TEST(BinaryTreeTest, ViewLookup)
+{
+    const std::vector<uint8_t> data = encode(readJsonFromBuffer(s_document));
+    const BinaryTreeView       root = BinaryTreeView::root(data);
+
+    EXPECT_TRUE(root.isMap());
+    EXPECT_EQ(root.size(), 5u);
+    EXPECT_TRUE(root.contains("n"));
+    EXPECT_FALSE(root.contains("zz"));
+    EXPECT_EQ(root["bb"]["k"].getScalar().toStringView(), "very long string value here");
+    EXPECT_EQ(root["a"][7].getScalar().toInt(), INT64_MAX);
+    EXPECT_EQ(root["a"][8].getScalar().toInt(), -INT64_MAX);
+    EXPECT_TRUE(root["a"][6].isNull());
+    EXPECT_THROW(root["zz"], std::out_of_range);
+    EXPECT_THROW(root["a"][9], std::out_of_range);
+
+    std::vector<std::string_view> keys;
+    for (const BinaryTreeView child : root)
+        keys.push_back(child.key());
+    EXPECT_EQ(keys, (std::vector<std::string_view>{ "a", "bb", "e", "k", "n" }));
+}
+
+TEST(BinaryTreeTest, MalformedInput)
+{
+    const std::vector<uint8_t> data = encode(readJsonFromBuffer(s_document));
+
+    for (size_t size : { size_t(0), size_t(4), data.size() - 3 })
+        EXPECT_THROW(readBinaryTreeFromBuffer(std::span(data).first(size)), std::runtime_error);
+
+    std::vector<uint8_t> badMagic = data;
+    badMagic[0]                   = 'X';
+    EXPECT_THROW(BinaryTreeView::root(badMagic), std::runtime_error);
+
+    std::vector<uint8_t> badVersion = data;
+    badVersion[4]                   = 2;
+    EXPECT_THROW(BinaryTreeView::root(badVersion), std::runtime_error);
+
+    std::vector<uint8_t> badTag = header(12);
+    badTag.push_back(42);
+    EXPECT_THROW(BinaryTreeView::root(badTag), std::runtime_error);
+
+    std::vector<uint8_t> hugeList = header(12);
+    hugeList.insert(hugeList.end(), { 6, 0xFF, 0xFF, 0xFF, 0x0F });
+    EXPECT_THROW(readBinaryTreeFromBuffer(hugeList), std::runtime_error);
+}
+
+TEST(BinaryTreeTest, MalformedOffsets)
+{
+    // list whose only child is itself.
+    std::vector<uint8_t> selfList = header(12);
+    selfList.insert(selfList.end(), { 6, 1, 12, 0, 0, 0 });
+    EXPECT_THROW(readBinaryTreeFromBuffer(selfList), std::runtime_error);
+    EXPECT_THROW(BinaryTreeView::root(selfList)[0], std::runtime_error);
+
+    // child placed after its parent.
+    std::vector<uint8_t> forwardChild = header(12);
+    forwardChild.insert(forwardChild.end(), { 6, 1, 18, 0, 0, 0, 0 });
+    EXPECT_THROW(readBinaryTreeFromBuffer(forwardChild), std::runtime_error);
+
+    // map with key and value pointing to the map itself.
+    std::vector<uint8_t> selfMap = header(12);
+    selfMap.insert(selfMap.end(), { 7, 1, 12, 0, 0, 0, 12, 0, 0, 0 });
+    EXPECT_THROW(readBinaryTreeFromBuffer(selfMap), std::runtime_error);
+    EXPECT_THROW(BinaryTreeView::root(selfMap).find("a"), std::runtime_error);
+
+    // child pointing into the header.
+    std::vector<uint8_t> headerChild = header(12);
+    headerChild.insert(headerChild.end(), { 6, 1, 8, 0, 0, 0 });
+    EXPECT_THROW(readBinaryTreeFromBuffer(headerChild), std::runtime_error);
+
+    // root inside the header.
+    std::vector<uint8_t> headerRoot = header(4);
+    headerRoot.push_back(0);
+    EXPECT_THROW(BinaryTreeView::root(headerRoot), std::runtime_error);
+
+    // valid: child before parent.
+    std::vector<uint8_t> valid = header(13);
+    valid.insert(valid.end(), { 2, 6, 1, 12, 0, 0, 0 });
+    EXPECT_EQ(readBinaryTreeFromBuffer(valid), readJsonFromBuffer("[true]"));
+}
+
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/ByteOrderStream.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <random>
+
+namespace Mernel {
+
+namespace {
+
+struct RecordFixed {
+    int32_t                m_x = 0;
+    int32_t                m_y = 0;
+    double                 m_weight = 0;
+    uint8_t                m_flag = 0;
+    std::array<uint8_t, 3> m_tag{};
+
+    static constexpr size_t s_binarySize = 4 + 4 + 8 + 1 + 3 + 2;
+
+    void readBinary(ByteOrderReadCursor& cursor)
+    {
+        cursor >> m_x >> m_y >> m_weight >> m_flag >> m_tag;
+        cursor.zeroPadding(2);
+    }
+    void writeBinary(ByteOrderWriteCursor& cursor) const
+    {
+        cursor << m_x << m_y << m_weight << m_flag << m_tag;
+        cursor.zeroPadding(2);
+    }
+
+    bool operator==(const RecordFixed&) const = default;
+};
+
+struct RecordChecked {
+    int32_t                m_x = 0;
+    int32_t                m_y = 0;
+    double                 m_weight = 0;
+    uint8_t                m_flag = 0;
+    std::array<uint8_t, 3> m_tag{};
+
+    void readBinary(ByteOrderDataStreamReader& stream)
+    {
+        stream >> m_x >> m_y >> m_weight >> m_flag >> m_tag;
+        stream.zeroPadding(2);
+    }
+    void writeBinary(ByteOrderDataStreamWriter& stream) const
+    {
+        stream << m_x << m_y << m_weight << m_flag << m_tag;
+        stream.zeroPadding(2);
+    }
+
+    bool operator==(const RecordChecked&) const = default;
+};
+
+static_assert(HasFixedSizeRead<RecordFixed> && HasFixedSizeWrite<RecordFixed>);
+static_assert(!HasFixedSizeRead<RecordChecked> && HasRead<RecordChecked>);
+
+template<std::endian order>
+struct OrderTraits {
+    using Reader = ByteOrderDataStreamReaderT<order>;
+    using Writer = ByteOrderDataStreamWriterT<order>;
+
+    static constexpr uint_fast8_t s_mask = order == std::endian::little ? ByteOrderDataStream::s_littleEndian : ByteOrderDataStream::s_bigEndian;
+};
+
+template<class T>
+std::vector<T> makeRandom(size_t size)
+{
+    std::mt19937_64 rng(size);
+    std::vector<T>  result(size);
+    for (T& value : result) {
+        const uint64_t bits = rng();
+        std::memcpy(&value, &bits, sizeof(T));
+        if constexpr (std::is_floating_point_v<T>) {
+            if (value != value)
+                value = T(1);
+        }
+    }
+    return result;
+}
+
+template<class T>
+void checkBulk(uint_fast8_t mask, size_t size)
+{
+    const std::vector<T> values = makeRandom<T>(size);
+
+    ByteOrderBuffer bulk, scalar;
+    {
+        ByteOrderDataStreamWriter writer(bulk, mask);
+        writer << values;
+    }
+    {
+        ByteOrderDataStreamWriter writer(scalar, mask);
+        writer.writeSize(values.size());
+        for (const T& value : values)
+            writer << value;
+    }
+    ASSERT_EQ(bulk.getSize(), scalar.getSize());
+    ASSERT_EQ(std::memcmp(bulk.begin(), scalar.begin(), bulk.getSize()), 0);
+
+    std::vector<T>            result;
+    ByteOrderDataStreamReader reader(scalar, mask);
+    reader >> result;
+    ASSERT_EQ(result.size(), size);
+    if (size > 0)
+        EXPECT_EQ(std::memcmp(result.data(), values.data(), size * sizeof(T)), 0);
+}
+
+}
+
+template<class Traits>
+class ByteOrderStreamTest : public testing::Test {};
+
+using Orders = testing::Types<OrderTraits<std::endian::little>, OrderTraits<std::endian::big>>;
+TYPED_TEST_SUITE(ByteOrderStreamTest, Orders);
+
+TYPED_TEST(ByteOrderStreamTest, BulkMatchesScalar)
+{
+    for (size_t size : { 0, 1, 3, 7, 15, 16, 17, 33, 100, 1001 }) {
+        checkBulk<uint8_t>(TypeParam::s_mask, size);
+        checkBulk<int16_t>(TypeParam::s_mask, size);
+        checkBulk<uint16_t>(TypeParam::s_mask, size);
+        checkBulk<int32_t>(TypeParam::s_mask, size);
+        checkBulk<uint32_t>(TypeParam::s_mask, size);
+        checkBulk<int64_t>(TypeParam::s_mask, size);
+        checkBulk<uint64_t>(TypeParam::s_mask, size);
+        checkBulk<float>(TypeParam::s_mask, size);
+        checkBulk<double>(TypeParam::s_mask, size);
+    }
+}
+
+TYPED_TEST(ByteOrderStreamTest, BulkTruncatedThrows)
+{
+    ByteOrderBuffer buffer;
+    {
+        ByteOrderDataStreamWriter writer(buffer, TypeParam::s_mask);
+        writer.writeSize(10);
+        writer << uint32_t(1);
+    }
+    ByteOrderDataStreamReader reader(buffer, TypeParam::s_mask);
+    std::vector<uint32_t>     result;
+    EXPECT_THROW(reader >> result, std::runtime_error);
+}
+
+TYPED_TEST(ByteOrderStreamTest, FixedOrderMatchesRuntimeMask)
+{
+    ByteOrderBuffer fixed, runtime;
+    {
+        typename TypeParam::Writer writer(fixed);
+        writer << uint8_t(1) << int16_t(-2) << uint32_t(0xDEADBEEF) << int64_t(-1234567890123) << 1.5f << 2.75 << true << std::string("x");
+    }
+    {
+        ByteOrderDataStreamWriter writer(runtime, TypeParam::s_mask);
+        writer << uint8_t(1) << int16_t(-2) << uint32_t(0xDEADBEEF) << int64_t(-1234567890123) << 1.5f << 2.75 << true << std::string("x");
+    }
+    ASSERT_EQ(fixed.getSize(), runtime.getSize());
+    ASSERT_EQ(std::memcmp(fixed.begin(), runtime.begin(), fixed.getSize()), 0);
+
+    typename TypeParam::Reader reader(runtime);
+    uint8_t                    a;
+    int16_t                    b;
+    uint32_t                   c;
+    int64_t                    d;
+    float                      f;
+    double                     g;
+    bool                       h;
+    std::string                s;
+    reader >> a >> b >> c >> d >> f >> g >> h >> s;
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(b, -2);
+    EXPECT_EQ(c, 0xDEADBEEF);
+    EXPECT_EQ(d, -1234567890123);
+    EXPECT_EQ(f, 1.5f);
+    EXPECT_EQ(g, 2.75);
+    EXPECT_TRUE(h);
+    EXPECT_EQ(s, "x");
+    EXPECT_THROW(reader.template readScalar<uint32_t>(), std::runtime_error);
+}
+
+TYPED_TEST(ByteOrderStreamTest, CursorMatchesCheckedStream)
+{
+    std::vector<RecordFixed>   fixed;
+    std::vector<RecordChecked> checked;
+    for (int i = 0; i < 100; ++i) {
+        fixed.push_back({ i, -i, i * 0.5, uint8_t(i), { 1, 2, uint8_t(i) } });
+        checked.push_back({ i, -i, i * 0.5, uint8_t(i), { 1, 2, uint8_t(i) } });
+    }
+
+    ByteOrderBuffer fixedBuffer, checkedBuffer;
+    {
+        ByteOrderDataStreamWriter writer(fixedBuffer, TypeParam::s_mask);
+        writer << fixed << fixed[3] << uint16_t(7);
+    }
+    {
+        ByteOrderDataStreamWriter writer(checkedBuffer, TypeParam::s_mask);
+        writer << checked << checked[3] << uint16_t(7);
+    }
+    ASSERT_EQ(fixedBuffer.getSize(), checkedBuffer.getSize());
+    ASSERT_EQ(std::memcmp(fixedBuffer.begin(), checkedBuffer.begin(), fixedBuffer.getSize()), 0);
+
+    ByteOrderDataStreamReader reader(fixedBuffer, TypeParam::s_mask);
+    std::vector<RecordFixed>  result;
+    RecordFixed               single;
+    uint16_t                  tail = 0;
+    reader >> result >> single >> tail;
+    EXPECT_EQ(result, fixed);
+    EXPECT_EQ(single, fixed[3]);
+    EXPECT_EQ(tail, 7);
+    EXPECT_EQ(reader.getBuffer().getRemainRead(), 0);
+}
+
+TYPED_TEST(ByteOrderStreamTest, ReserveCursor)
+{
+    ByteOrderBuffer buffer;
+    {
+        ByteOrderDataStreamWriter writer(buffer, TypeParam::s_mask);
+        {
+            auto cursor = writer.reserveWrite(6);
+            cursor << uint16_t(1) << uint32_t(2);
+            EXPECT_EQ(cursor.remaining(), 0u);
+        }
+        writer << uint8_t(9);
+    }
+
+    ByteOrderDataStreamReader reader(buffer, TypeParam::s_mask);
+    {
+        auto cursor = reader.reserveRead(6);
+        EXPECT_EQ(cursor.template readScalar<uint16_t>(), 1);
+        EXPECT_EQ(cursor.template readScalar<uint32_t>(), 2u);
+    }
+    EXPECT_EQ(reader.template readScalar<uint8_t>(), 9);
+    EXPECT_THROW(reader.reserveRead(1), std::runtime_error);
+
+    // truncated record throws before any field is read.
+    buffer.resetRead();
+    ByteOrderDataStreamReader truncated(buffer, TypeParam::s_mask);
+    RecordFixed               record;
+    EXPECT_THROW(truncated >> record, std::runtime_error);
+    EXPECT_EQ(truncated.getBuffer().getOffsetRead(), 0);
+}
+
+TYPED_TEST(ByteOrderStreamTest, Views)
+{
+    const std::vector<uint32_t> values{ 1, 2, 0xA0B0C0D0 };
+
+    ByteOrderBuffer buffer;
+    {
+        ByteOrderDataStreamWriter writer(buffer, TypeParam::s_mask);
+        writer << std::string("hello") << values << std::string("") << std::string("end");
+    }
+
+    ByteOrderDataStreamReader reader(buffer, TypeParam::s_mask);
+    std::string_view          hello;
+    reader >> hello;
+    EXPECT_EQ(hello, "hello");
+
+    // array data at offset 13 is unaligned: view is refused and read offset is kept.
+    std::span<const uint32_t> view;
+    const ptrdiff_t           before = reader.getBuffer().getOffsetRead();
+    EXPECT_FALSE(reader.readArrayView(view));
+    EXPECT_EQ(reader.getBuffer().getOffsetRead(), before);
+    std::vector<uint32_t> copy;
+    reader >> copy;
+    EXPECT_EQ(copy, values);
+
+    EXPECT_TRUE(reader.readPascalStringView().empty());
+    EXPECT_EQ(reader.readPascalStringView(), "end");
+}
+
+TYPED_TEST(ByteOrderStreamTest, AlignedArrayView)
+{
+    ByteOrderBuffer buffer;
+    {
+        ByteOrderDataStreamWriter writer(buffer, TypeParam::s_mask);
+        auto                      guard = writer.setContainerSizeBytesGuarded(8);
+        writer << std::vector<double>{ 1.5, 2.5 };
+    }
+
+    ByteOrderDataStreamReader reader(buffer, TypeParam::s_mask);
+    auto                      guard = reader.setContainerSizeBytesGuarded(8);
+    std::span<const double>   view;
+    if (TypeParam::s_mask == ByteOrderDataStream::s_littleEndian && std::endian::native == std::endian::little) {
+        ASSERT_TRUE(reader.readArrayView(view));
+        ASSERT_EQ(view.size(), 2u);
+        EXPECT_EQ(view[1], 2.5);
+        EXPECT_EQ(static_cast<const void*>(view.data()), buffer.begin() + 8);
+        EXPECT_EQ(reader.getBuffer().getRemainRead(), 0);
+    } else {
+        EXPECT_FALSE(reader.readArrayView(view));
+        std::vector<double> copy;
+        reader >> copy;
+        EXPECT_EQ(copy, (std::vector<double>{ 1.5, 2.5 }));
+    }
+}
+
+}
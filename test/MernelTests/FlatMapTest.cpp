@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/FlatMap.hpp"
+#include "MernelPlatform/StableMap.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace Mernel {
+
+template<class Map>
+class FlatMapTest : public ::testing::Test {};
+
+using MapTypes = ::testing::Types<FlatMap<std::string, int>, StableMap<std::string, int>>;
+TYPED_TEST_SUITE(FlatMapTest, MapTypes);
+
+TYPED_TEST(FlatMapTest, KeepsKeysSorted)
+{
+    TypeParam map;
+    map["c"] = 3;
+    map["a"] = 1;
+    map.insert({ "b", 2 });
+    map.insert_or_assign(std::string("a"), 10);
+
+    ASSERT_EQ(map.size(), 3u);
+    auto it = map.begin();
+    EXPECT_EQ(it->first, "a");
+    EXPECT_EQ(it->second, 10);
+    ++it;
+    EXPECT_EQ(it->first, "b");
+    ++it;
+    EXPECT_EQ(it->first, "c");
+}
+
+TYPED_TEST(FlatMapTest, LookupAndErase)
+{
+    TypeParam map{ { "x", 1 }, { "y", 2 }, { "z", 3 } };
+
+    EXPECT_TRUE(map.contains(std::string_view("y")));
+    EXPECT_EQ(map.at("z"), 3);
+    EXPECT_THROW((void) map.at("w"), std::out_of_range);
+    EXPECT_EQ(map.find("w"), map.end());
+
+    EXPECT_EQ(map.erase(std::string("y")), 1u);
+    EXPECT_EQ(map.erase(std::string("y")), 0u);
+    EXPECT_FALSE(map.contains("y"));
+
+    EXPECT_EQ(map.erase_if([](const auto& pair) { return pair.second > 1; }), 1u);
+    ASSERT_EQ(map.size(), 1u);
+    EXPECT_EQ(map.begin()->first, "x");
+}
+
+TYPED_TEST(FlatMapTest, AppendUnsortedLastWins)
+{
+    TypeParam map;
+    map.appendUnsorted("b") = 1;
+    map.appendUnsorted("a") = 2;
+    map.appendUnsorted("b") = 3;
+    map.sortAppended();
+
+    ASSERT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.at("a"), 2);
+    EXPECT_EQ(map.at("b"), 3);
+}
+
+TEST(StableMapTest, KeepsReferencesOnInsert)
+{
+    StableMap<std::string, int> map;
+    int&                        a = map["a"];
+    for (int i = 0; i < 100; ++i)
+        map[std::to_string(i)] = i;
+    a = 42;
+    EXPECT_EQ(map.at("a"), 42);
+}
+
+}
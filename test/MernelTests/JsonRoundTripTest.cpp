@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/FileFormatJson.hpp"
+#include "MernelPlatform/FileFormatJsonEmitter.hpp"
+#include "MernelPlatform/FileFormatJsonLines.hpp"
+#include "MernelPlatform/FileFormatJsonView.hpp"
+#include "MernelPlatform/PropertyTreeArena.hpp"
+
+#include "MernelExecution/ParallelExecutor.hpp"
+#include "MernelExecution/TaskQueue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace Mernel {
+
+namespace {
+
+const std::string s_document = R"({"a":[1,-2,2.5,"x\ny\"z",true,false,null,9223372036854775807,0.5],)"
+                               R"("bb":{"k":"very long string value here","a":{}},"n":-3,"e":[],"u":"é\u0001"})";
+
+std::string makeLargeDocument(int size)
+{
+    std::string result = "{";
+    for (int i = 0; i < size; ++i) {
+        if (i)
+            result += ",";
+        result += "\"k" + std::to_string(i) + "\":{\"id\":" + std::to_string(i) + ",\"name\":\"item " + std::to_string(i) + "\",\"v\":[1.5,{\"x\":\"y\"}]}";
+    }
+    return result + "}";
+}
+
+}
+
+TEST(JsonRoundTripTest, BufferAndStream)
+{
+    const PropertyTree reference = readJsonFromBuffer(s_document);
+    ASSERT_TRUE(reference.isMap());
+    EXPECT_EQ(reference["a"].getList().size(), 9u);
+    EXPECT_EQ(reference["a"].getList()[3].getScalar().toStringView(), "x\ny\"z");
+
+    EXPECT_EQ(readJsonFromBuffer(writeJsonToBuffer(reference)), reference);
+    EXPECT_EQ(readJsonFromBuffer(writeJsonToBuffer(reference, true)), reference);
+
+    std::ostringstream os;
+    writeJsonToStream(os, reference);
+    EXPECT_EQ(os.str(), writeJsonToBuffer(reference));
+    EXPECT_EQ(writeJsonToBuffer(readJsonFromBuffer(writeJsonToBuffer(reference))), writeJsonToBuffer(reference));
+}
+
+TEST(JsonRoundTripTest, DoublesAreExact)
+{
+    const PropertyTree reference = readJsonFromBuffer("[0.1,0.3333333333333333,1e300,-2.5e-30,123456789.125]");
+    EXPECT_EQ(writeJsonToBuffer(readJsonFromBuffer("[0.1,1e20,2.0]")), "[0.1,1e+20,2.0]");
+    for (bool pretty : { false, true }) {
+        const PropertyTree restored = readJsonFromBuffer(writeJsonToBuffer(reference, pretty));
+        ASSERT_EQ(restored.getList().size(), 5u);
+        for (size_t i = 0; i < 5; ++i)
+            EXPECT_EQ(restored.getList()[i].getScalar().toDouble(), reference.getList()[i].getScalar().toDouble());
+    }
+}
+
+TEST(JsonRoundTripTest, ReadParams)
+{
+    const PropertyTree reference = readJsonFromBuffer(s_document);
+
+    JsonReadParams interned;
+    interned.m_internKeys = true;
+    const PropertyTree atoms = readJsonFromBuffer(s_document, interned);
+    EXPECT_EQ(atoms, reference);
+    EXPECT_TRUE(atoms.getMap().begin()->first.isAtom());
+
+    JsonReadParams borrowed;
+    borrowed.m_borrowStrings = true;
+    EXPECT_FALSE(readJsonFromBuffer(s_document, borrowed)["bb"]["k"].getScalar().isBorrowed());
+
+    std::string        mutableBuffer = s_document;
+    const PropertyTree inSitu        = readJsonFromMutableBuffer(mutableBuffer, borrowed);
+    EXPECT_EQ(inSitu, reference);
+    EXPECT_TRUE(inSitu["bb"]["k"].getScalar().isBorrowed());
+
+    // explicit length, no terminating zero needed.
+    std::string withTail = "[1,\"a\"]garbage";
+    EXPECT_EQ(readJsonFromMutableBuffer(std::span<char>(withTail.data(), 7)), readJsonFromBuffer("[1,\"a\"]"));
+
+    PropertyTreeArena arena;
+    {
+        PropertyTreeArena::Scope scope(arena);
+        EXPECT_EQ(readJsonFromBuffer(s_document), reference);
+
+        const PropertyTree inArena = readJsonFromBuffer(s_document, borrowed);
+        EXPECT_EQ(inArena, reference);
+        EXPECT_TRUE(inArena["bb"]["k"].getScalar().isBorrowed());
+    }
+}
+
+TEST(JsonRoundTripTest, ParallelParse)
+{
+    const std::string  document  = makeLargeDocument(2000);
+    const PropertyTree reference = readJsonFromBuffer(document);
+
+    ParallelExecutor exec(4);
+    TaskQueue        queue;
+    JsonReadParams   params;
+    params.m_parallelMinChildren = 64;
+    params.m_parallelRunner      = [&](std::vector<std::function<void()>> tasks) { execTasks(queue, exec, std::move(tasks)); };
+    EXPECT_EQ(readJsonFromBuffer(document, params), reference);
+}
+
+TEST(JsonRoundTripTest, DuplicateKeysLastWins)
+{
+    const PropertyTree tree = readJsonFromBuffer(R"({"b":1,"a":{"x":1,"x":[2]},"b":"3"})");
+    EXPECT_EQ(tree, readJsonFromBuffer(R"({"a":{"x":[2]},"b":"3"})"));
+    EXPECT_EQ(writeJsonToBuffer(tree), R"({"a":{"x":[2]},"b":"3"})");
+}
+
+TEST(JsonRoundTripTest, MalformedInput)
+{
+    PropertyTree result;
+    EXPECT_FALSE(readJsonFromBufferNoexcept("{\"a\":", result));
+    EXPECT_FALSE(readJsonFromBufferNoexcept("[1,]x", result));
+    EXPECT_THROW(readJsonFromBuffer("{\"a\" 1}"), std::exception);
+
+    // truncated tokens stop at the terminator of std::string, or at the end of mutable span even if memory after it completes them.
+    const std::pair<std::string, std::string> truncated[] = {
+        { "{\"a\":\"x", "\"}" }, { "{\"a\":\"x\\", "n\"}" }, { "{\"a\":\"\\u12", "34\"}" }, { "[tru", "e]" }, { "[1,  ", "2]" },
+    };
+    for (const auto& [text, rest] : truncated) {
+        EXPECT_FALSE(readJsonFromBufferNoexcept(text, result)) << text;
+
+        std::string complete = text + rest;
+        EXPECT_TRUE(readJsonFromBufferNoexcept(complete, result)) << complete;
+        EXPECT_FALSE(readJsonFromMutableBufferNoexcept(std::span<char>(complete.data(), text.size()), result)) << text;
+    }
+}
+
+TEST(JsonRoundTripTest, DocumentView)
+{
+    const PropertyTree reference = readJsonFromBuffer(s_document);
+    JsonDocument       document(s_document);
+    const JsonView     root = document.root();
+
+    EXPECT_EQ(root.toPropertyTree(), reference);
+    EXPECT_EQ(root.size(), 5u);
+    EXPECT_TRUE(root.contains("bb"));
+    EXPECT_FALSE(root.contains("zz"));
+    EXPECT_EQ(root["a"][3].getScalar().toStringView(), "x\ny\"z");
+    EXPECT_EQ(root["bb"]["a"].raw(), "{}");
+    EXPECT_EQ(root["n"].getScalar().toInt(), -3);
+
+    for (const JsonView child : root)
+        EXPECT_EQ(child.toPropertyTree(), reference[child.key()]);
+}
+
+TEST(JsonRoundTripTest, DocumentViewRejectsInvalidTokens)
+{
+    for (const char* text : { "[inf]", "[nan]", "[nope]", "[tru]", "[01]", "[1.]", "[.5]", "[1e]", "[-]", "[+1]", "[0x10]" }) {
+        JsonDocument document(text);
+        EXPECT_THROW((void) document.root().size(), std::runtime_error) << text;
+
+        const std::string buffer(text);
+        JsonCursor        cursor(buffer);
+        ASSERT_TRUE(cursor.enterList());
+        ASSERT_TRUE(cursor.nextElement());
+        EXPECT_THROW(cursor.skip(), std::runtime_error) << text;
+    }
+
+    JsonDocument document("[null,true,false,0,-0.5,1e5,2E-3,-10]");
+    EXPECT_EQ(document.root().toPropertyTree(), readJsonFromBuffer("[null,true,false,0,-0.5,1e5,2E-3,-10]"));
+}
+
+TEST(JsonRoundTripTest, Cursor)
+{
+    JsonCursor cursor(s_document);
+    ASSERT_TRUE(cursor.enterMap());
+
+    PropertyTree     result(PropertyTreeMap{});
+    std::string_view key;
+    while (cursor.nextMember(key))
+        result[std::string(key)] = cursor.readTree();
+    EXPECT_EQ(result, readJsonFromBuffer(s_document));
+}
+
+TEST(JsonRoundTripTest, Emitter)
+{
+    const PropertyTree reference = readJsonFromBuffer(s_document);
+
+    std::string buffer;
+    JsonEmitter emitter(buffer);
+    emitter.beginMap();
+    emitter.key("tree");
+    emitter.writeTree(reference);
+    emitter.key("list");
+    emitter.beginList();
+    emitter.writeNull();
+    emitter.writeBool(true);
+    emitter.writeInt(-7);
+    emitter.writeDouble(0.5);
+    emitter.writeString("q\"\n");
+    emitter.endList();
+    emitter.endMap();
+
+    const PropertyTree parsed = readJsonFromBuffer(buffer);
+    EXPECT_EQ(parsed["tree"], reference);
+    EXPECT_EQ(parsed["list"], readJsonFromBuffer(R"([null,true,-7,0.5,"q\"\n"])"));
+
+    std::string treeOnly;
+    JsonEmitter(treeOnly).writeTree(reference);
+    EXPECT_EQ(treeOnly, writeJsonToBuffer(reference));
+}
+
+TEST(JsonRoundTripTest, PrettyOutput)
+{
+    const PropertyTree tree = readJsonFromBuffer(R"({"a":[1,-2,2.5,"x\ny",true,false,null,0.5],"bb":{"k":"v\\w","a":{},"l":[[1],{"q":1}]},)"
+                                                 R"("n":-3,"e":[],"f":{"x":[1,2],"y":1.0e20}})");
+    const std::string  expected = "{\n"
+                                  "    \"a\": \n"
+                                  "        [1, -2, 2.5, \"x\\u000ay\", true, false, null, 0.5], \n"
+                                  "    \"bb\": \n"
+                                  "        {\n"
+                                  "            \"a\": \n"
+                                  "                {}, \n"
+                                  "            \"k\": \"v\\\\w\", \n"
+                                  "            \"l\": \n"
+                                  "                [\n"
+                                  "                    [1], \n"
+                                  "                    {\"q\": 1}\n"
+                                  "                ]\n"
+                                  "        }, \n"
+                                  "    \"e\": \n"
+                                  "        [], \n"
+                                  "    \"f\": \n"
+                                  "        {\"x\": [1, 2], \"y\": 1e+20}, \n"
+                                  "    \"n\": -3\n"
+                                  "}\n";
+    EXPECT_EQ(writeJsonToBuffer(tree, true), expected);
+
+    std::ostringstream os;
+    writeJsonToStream(os, tree, true);
+    EXPECT_EQ(os.str(), expected);
+    EXPECT_EQ(readJsonFromBuffer(expected), tree);
+}
+
+TEST(JsonRoundTripTest, JsonLines)
+{
+    std::vector<PropertyTree> records;
+    for (int i = 0; i < 100; ++i)
+        records.push_back(readJsonFromBuffer("{\"id\":" + std::to_string(i) + ",\"s\":\"line\\n" + std::to_string(i) + "\"}"));
+
+    std::stringstream stream;
+    {
+        JsonLinesWriter writer(stream, 64);
+        for (const PropertyTree& record : records)
+            writer.write(record);
+        writer.flush();
+    }
+
+    JsonLinesReader           reader(stream, {}, 64);
+    std::vector<PropertyTree> result;
+    PropertyTree              record;
+    ASSERT_TRUE(reader.next(record));
+    result.push_back(record);
+
+    std::vector<PropertyTree> batch;
+    while (reader.nextBatch(batch, 7) > 0)
+        result.insert(result.end(), batch.begin(), batch.end());
+    EXPECT_EQ(result, records);
+    EXPECT_EQ(reader.lineNumber(), records.size());
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/ByteOrderStream.hpp"
+#include "MernelPlatform/FileIOUtils.hpp"
+#include "MernelPlatform/MappedFile.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+
+namespace Mernel {
+
+namespace {
+
+std::vector<uint32_t> makeValues()
+{
+    std::vector<uint32_t> result(1000);
+    std::iota(result.begin(), result.end(), 0xA0B0C000u);
+    return result;
+}
+
+}
+
+TEST(MappedFileTest, ReadOnlyView)
+{
+    const std_path path = std::filesystem::temp_directory_path() / "mernel_mapped_test.bin";
+
+    ByteOrderBuffer source;
+    {
+        ByteOrderDataStreamWriterLE writer(source);
+        writer << makeValues() << std::string("tail");
+    }
+    ByteArrayHolder holder;
+    holder.resize(source.getSize());
+    std::memcpy(holder.data(), source.begin(), source.getSize());
+    writeFileFromHolder(path, holder);
+
+    MappedFile file(path);
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(file.size(), source.getSize());
+
+    ByteOrderBuffer view(file.data());
+    EXPECT_TRUE(view.isReadOnly());
+
+    ByteOrderDataStreamReaderLE reader(view);
+    std::vector<uint32_t>       values;
+    std::string                 tail;
+    reader >> values >> tail;
+    EXPECT_EQ(values, makeValues());
+    EXPECT_EQ(tail, "tail");
+
+    ByteOrderDataStreamWriterLE writer(view);
+    EXPECT_THROW(writer << uint8_t(1), std::runtime_error);
+
+    file.close();
+    std::filesystem::remove(path);
+
+    MappedFile missing;
+    EXPECT_FALSE(missing.open(path));
+    EXPECT_THROW(MappedFile{ path }, std::runtime_error);
+}
+
+TEST(MappedFileTest, EmptyFile)
+{
+    const std_path path = std::filesystem::temp_directory_path() / "mernel_mapped_empty.bin";
+    writeFileFromBuffer(path, std::string());
+    {
+        MappedFile file(path);
+        EXPECT_TRUE(file.isOpen());
+        EXPECT_EQ(file.size(), 0u);
+        EXPECT_TRUE(file.data().empty());
+    }
+    std::filesystem::remove(path);
+}
+
+}
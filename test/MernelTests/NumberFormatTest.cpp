@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/NumberFormat.hpp"
+#include "MernelPlatform/PropertyTree.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+
+namespace Mernel {
+
+TEST(NumberFormatTest, Format)
+{
+    EXPECT_EQ(numberToString(0), "0");
+    EXPECT_EQ(numberToString(std::numeric_limits<int64_t>::min()), "-9223372036854775808");
+    EXPECT_EQ(numberToString(0.1), "0.1");
+    EXPECT_EQ(numberToString(123456789.125), "123456789.125");
+    EXPECT_EQ(numberToString(1e20), "1e+20");
+
+    std::string withPoint;
+    appendDoubleWithPoint(withPoint, 2.0);
+    withPoint += ' ';
+    appendDoubleWithPoint(withPoint, -0.5);
+    withPoint += ' ';
+    appendDoubleWithPoint(withPoint, 1e20);
+    EXPECT_EQ(withPoint, "2.0 -0.5 1e+20");
+
+    EXPECT_EQ(PropertyTreeScalar(2.5).dump(), "2.5f");
+}
+
+TEST(NumberFormatTest, Parse)
+{
+    int    i = 7;
+    double d = 0;
+    EXPECT_TRUE(parseNumber(" +42 ", i));
+    EXPECT_EQ(i, 42);
+    EXPECT_FALSE(parseNumber("42x", i));
+    EXPECT_EQ(i, 42);
+    EXPECT_TRUE(parseNumber("42x", i, true));
+    EXPECT_FALSE(parseNumber("+-1", i));
+    EXPECT_FALSE(parseNumber("", i));
+    EXPECT_FALSE(parseNumber("99999999999", i));
+
+    EXPECT_TRUE(parseNumber("0.3333333333333333", d));
+    EXPECT_EQ(d, 1.0 / 3);
+    EXPECT_TRUE(parseNumber("-2.5e-30", d));
+    EXPECT_EQ(d, -2.5e-30);
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/PropertyTree.hpp"
+#include "MernelPlatform/PropertyTreeArena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace Mernel {
+
+namespace {
+
+PropertyTree makeDocument(int size)
+{
+    PropertyTree doc;
+    doc.convertToMap();
+    for (int i = 0; i < size; ++i) {
+        PropertyTree item;
+        item["id"]   = PropertyTreeScalar(i);
+        item["name"] = PropertyTreeScalar("item_" + std::to_string(i));
+        doc["list"].append(std::move(item));
+    }
+    return doc;
+}
+
+}
+
+TEST(PropertyTreeArenaTest, ContainersUseCurrentArena)
+{
+    PropertyTreeArena arena;
+    PropertyTree      tree;
+    {
+        PropertyTreeArena::Scope scope(arena);
+        EXPECT_EQ(PropertyTreeArena::current(), &arena);
+        tree = makeDocument(100);
+    }
+    EXPECT_EQ(PropertyTreeArena::current(), nullptr);
+    EXPECT_GT(arena.getUsedBytes(), 0u);
+    EXPECT_GE(arena.getReservedBytes(), arena.getUsedBytes());
+    EXPECT_EQ(tree["list"].getList().get_allocator().getArena(), &arena);
+
+    EXPECT_EQ(tree, makeDocument(100));
+}
+
+TEST(PropertyTreeArenaTest, NestedScopesRestorePrevious)
+{
+    PropertyTreeArena outer;
+    PropertyTreeArena inner;
+    {
+        PropertyTreeArena::Scope scopeOuter(outer);
+        {
+            PropertyTreeArena::Scope scopeInner(inner);
+            EXPECT_EQ(PropertyTreeArena::current(), &inner);
+        }
+        EXPECT_EQ(PropertyTreeArena::current(), &outer);
+    }
+    EXPECT_EQ(PropertyTreeArena::current(), nullptr);
+}
+
+TEST(PropertyTreeArenaTest, CopyOutsideScopeLeavesArena)
+{
+    PropertyTree copy;
+    {
+        PropertyTreeArena arena;
+        PropertyTree      tree;
+        {
+            PropertyTreeArena::Scope scope(arena);
+            tree = makeDocument(10);
+        }
+        copy = tree;
+        EXPECT_FALSE(copy.isSharedWith(tree));
+        EXPECT_EQ(copy["list"].getList().get_allocator().getArena(), nullptr);
+    }
+    EXPECT_EQ(copy, makeDocument(10));
+}
+
+TEST(PropertyTreeArenaTest, LargeAllocationGetsOwnBlock)
+{
+    PropertyTreeArena arena(1024);
+    void*             small = arena.allocate(16, 8);
+    void*             large = arena.allocate(4096, 64);
+    ASSERT_NE(small, nullptr);
+    ASSERT_NE(large, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % 64, 0u);
+    EXPECT_GE(arena.getReservedBytes(), 4096u + 16u);
+}
+
+}
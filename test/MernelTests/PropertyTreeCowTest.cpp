@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/FileFormatJson.hpp"
+#include "MernelPlatform/PropertyTree.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace Mernel {
+
+namespace {
+
+PropertyTree makeDocument(int size)
+{
+    PropertyTree doc;
+    doc.convertToMap();
+    for (int i = 0; i < size; ++i) {
+        PropertyTree item;
+        item["id"]   = PropertyTreeScalar(i);
+        item["name"] = PropertyTreeScalar("item_" + std::to_string(i));
+        doc["list"].append(std::move(item));
+    }
+    return doc;
+}
+
+}
+
+TEST(PropertyTreeCowTest, CopyIsDeepUntilShared)
+{
+    PropertyTree original = makeDocument(5);
+    PropertyTree copy     = original;
+    EXPECT_FALSE(original.isShared());
+    EXPECT_FALSE(copy.isSharedWith(original));
+    EXPECT_EQ(copy, original);
+}
+
+TEST(PropertyTreeCowTest, CopySharesUntilWrite)
+{
+    PropertyTree original = makeDocument(5);
+    original.share();
+    EXPECT_TRUE(original.isShared());
+    EXPECT_TRUE(std::as_const(original)["list"].getList()[0].isShared());
+
+    PropertyTree copy = original;
+    EXPECT_TRUE(copy.isSharedWith(original));
+
+    copy["list"].append(PropertyTreeScalar(42));
+    EXPECT_FALSE(copy.isSharedWith(original));
+    EXPECT_TRUE(std::as_const(copy)["list"].getList()[0].isSharedWith(std::as_const(original)["list"].getList()[0]));
+    EXPECT_EQ(std::as_const(original)["list"].getList().size(), 5u);
+    EXPECT_EQ(std::as_const(copy)["list"].getList().size(), 6u);
+}
+
+TEST(PropertyTreeCowTest, OnlyOwnerMovesNodeOut)
+{
+    PropertyTree tree = makeDocument(5);
+    tree.share();
+    const PropertyTree* first = &std::as_const(tree)["list"].getList()[0];
+
+    // no other owner: containers are moved out of their nodes, element addresses are kept.
+    EXPECT_EQ(&tree["list"].getList()[0], first);
+    EXPECT_FALSE(tree.isShared());
+    EXPECT_FALSE(std::as_const(tree)["list"].isShared());
+    EXPECT_TRUE(first->isShared());
+
+    tree.share();
+    EXPECT_TRUE(tree.isShared());
+    EXPECT_EQ(&std::as_const(tree)["list"].getList()[0], first);
+}
+
+TEST(PropertyTreeCowTest, MutableReferenceDoesNotModifyCopy)
+{
+    PropertyTree tree = makeDocument(3);
+    tree.share();
+    auto&        map  = tree.getMap();
+    PropertyTree snap = tree;
+    map["k"]          = PropertyTreeScalar(1);
+    EXPECT_FALSE(snap.contains("k"));
+    EXPECT_TRUE(tree.contains("k"));
+
+    tree.share();
+    auto&        list    = tree["list"].getList();
+    PropertyTree snapTwo = tree;
+    list.push_back(PropertyTreeScalar(2));
+    EXPECT_EQ(std::as_const(snapTwo)["list"].getList().size(), 3u);
+    EXPECT_EQ(std::as_const(tree)["list"].getList().size(), 4u);
+
+    tree.share();
+    PropertyTree& child     = tree["list"].getList()[0];
+    PropertyTree  snapThree = tree;
+    child["id"]             = PropertyTreeScalar(100);
+    EXPECT_EQ(std::as_const(snapThree)["list"].getList()[0]["id"].getScalar().toInt(), 0);
+    EXPECT_EQ(std::as_const(tree)["list"].getList()[0]["id"].getScalar().toInt(), 100);
+}
+
+TEST(PropertyTreeCowTest, SharedHashIsCached)
+{
+    PropertyTree parsed = readJsonFromBuffer(R"({"a":[1,{"b":2}],"c":{}})");
+    EXPECT_FALSE(parsed.cachedHash().has_value());
+    const uint64_t hash = parsed.hash();
+    EXPECT_FALSE(parsed.cachedHash().has_value());
+
+    parsed.share();
+    EXPECT_EQ(parsed.hash(), hash);
+    EXPECT_EQ(parsed.cachedHash(), hash);
+
+    PropertyTree copy = parsed;
+    copy["a"].append(PropertyTreeScalar(3));
+    EXPECT_FALSE(copy.cachedHash().has_value());
+    EXPECT_NE(copy.hash(), hash);
+    EXPECT_EQ(parsed.cachedHash(), hash);
+    EXPECT_FALSE(copy == parsed);
+}
+
+TEST(PropertyTreeCowTest, SharedTreesCompareByHash)
+{
+    PropertyTree one   = makeDocument(5);
+    PropertyTree two   = makeDocument(5);
+    PropertyTree other = makeDocument(6);
+    one.share();
+    two.share();
+    other.share();
+    (void) one.hash();
+    (void) two.hash();
+    (void) other.hash();
+
+    EXPECT_FALSE(one.isSharedWith(two));
+    EXPECT_EQ(one, two);
+    EXPECT_FALSE(one == other);
+}
+
+TEST(PropertyTreeCowTest, RemoveEqualValuesOfSharedCopy)
+{
+    PropertyTree original = makeDocument(3);
+    original.share();
+    PropertyTree copy               = original;
+    copy["list"].getList()[1]["id"] = PropertyTreeScalar(100);
+
+    PropertyTree::removeEqualValues(original, copy);
+    const auto& originalList = std::as_const(original)["list"].getList();
+    const auto& copyList     = std::as_const(copy)["list"].getList();
+    ASSERT_EQ(originalList.size(), 3u);
+    ASSERT_EQ(copyList.size(), 3u);
+    EXPECT_TRUE(originalList[0].isNull());
+    EXPECT_TRUE(copyList[2].isNull());
+    EXPECT_EQ(originalList[1], readJsonFromBuffer(R"({"id":1})"));
+    EXPECT_EQ(copyList[1], readJsonFromBuffer(R"({"id":100})"));
+}
+
+}
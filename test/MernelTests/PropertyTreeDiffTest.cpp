@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/FileFormatJson.hpp"
+#include "MernelPlatform/PropertyTree.hpp"
+
+#include <gtest/gtest.h>
+
+#include <unordered_set>
+
+namespace Mernel {
+
+namespace {
+
+PropertyTree json(const std::string& text)
+{
+    return readJsonFromBuffer(text);
+}
+
+}
+
+TEST(PropertyTreeDiffTest, MergePatchRfcExample)
+{
+    PropertyTree target = json(R"({"title":"Goodbye!","author":{"givenName":"John","familyName":"Doe"},"tags":["example","sample"],"content":"This will be unchanged"})");
+    PropertyTree patch  = json(R"({"title":"Hello!","phoneNumber":"+01-123-456-7890","author":{"familyName":null},"tags":["example"]})");
+    PropertyTree result = json(R"({"title":"Hello!","author":{"givenName":"John"},"tags":["example"],"content":"This will be unchanged","phoneNumber":"+01-123-456-7890"})");
+
+    PropertyTree copyTarget = target;
+    PropertyTree::mergePatch(copyTarget, patch);
+    EXPECT_EQ(copyTarget, result);
+
+    PropertyTree moveTarget = target;
+    PropertyTree::mergePatch(moveTarget, PropertyTree(patch));
+    EXPECT_EQ(moveTarget, result);
+}
+
+TEST(PropertyTreeDiffTest, MergePatchReplacesNonMap)
+{
+    PropertyTree dest = json(R"({"a":[1,2,3]})");
+    PropertyTree::mergePatch(dest, json(R"({"a":{"b":1},"c":null})"));
+    EXPECT_EQ(dest, json(R"({"a":{"b":1}})"));
+
+    PropertyTree::mergePatch(dest, json(R"([1])"));
+    EXPECT_EQ(dest, json(R"([1])"));
+}
+
+TEST(PropertyTreeDiffTest, MergePatchSmallPatchIntoLargeMap)
+{
+    auto makeMap = [](bool patched) {
+        PropertyTree map;
+        map.convertToMap();
+        for (int i = 0; i < 1000; ++i) {
+            if (patched && (i == 5 || i == 999))
+                continue;
+            const std::string key = std::to_string(10000 + i);
+            map[key]              = PropertyTreeScalar(i);
+        }
+        if (patched) {
+            map["10500"] = json(R"({"x":1})");
+            map["0"]     = PropertyTreeScalar(1);
+            map["2"]     = PropertyTreeScalar(2);
+        }
+        return map;
+    };
+    const PropertyTree patch = json(R"({"10005":null,"10500":{"x":1},"0":1,"2":2,"10999":null,"3":null})");
+    const PropertyTree dest  = makeMap(false);
+
+    PropertyTree copyTarget = dest;
+    PropertyTree::mergePatch(copyTarget, patch);
+    EXPECT_EQ(copyTarget, makeMap(true));
+
+    PropertyTree moveTarget = dest;
+    PropertyTree::mergePatch(moveTarget, PropertyTree(patch));
+    EXPECT_EQ(moveTarget, makeMap(true));
+}
+
+TEST(PropertyTreeDiffTest, DiffIsMinimalPatch)
+{
+    PropertyTree from = json(R"({"same":1,"changed":2,"removed":3,"nested":{"x":1,"y":2},"list":[1,2]})");
+    PropertyTree to   = json(R"({"same":1,"changed":5,"added":4,"nested":{"x":1,"y":3},"list":[1,2]})");
+
+    PropertyTree patch = PropertyTree::diff(from, to);
+    EXPECT_EQ(patch, json(R"({"changed":5,"removed":null,"added":4,"nested":{"y":3}})"));
+
+    PropertyTree applied = from;
+    PropertyTree::mergePatch(applied, patch);
+    EXPECT_EQ(applied, to);
+
+    EXPECT_EQ(PropertyTree::diff(from, from), json("{}"));
+    EXPECT_EQ(PropertyTree::diff(json(R"({"n":null,"a":1})"), json(R"({"n":null,"a":2})")), json(R"({"a":2})"));
+}
+
+TEST(PropertyTreeDiffTest, RemoveEqualValues)
+{
+    PropertyTree one = json(R"({"a":1,"b":2,"c":{"d":1,"e":2},"f":{"g":1}})");
+    PropertyTree two = json(R"({"a":1,"b":3,"c":{"d":1,"e":5},"f":{"g":1},"h":1})");
+
+    PropertyTree::removeEqualValues(one, two);
+    EXPECT_EQ(one, json(R"({"b":2,"c":{"e":2}})"));
+    EXPECT_EQ(two, json(R"({"b":3,"c":{"e":5},"h":1})"));
+
+    PropertyTree same1 = json(R"({"a":[1,2]})");
+    PropertyTree same2 = same1;
+    PropertyTree::removeEqualValues(same1, same2);
+    EXPECT_TRUE(same1.isNull());
+    EXPECT_TRUE(same2.isNull());
+}
+
+TEST(PropertyTreeDiffTest, HashFollowsEquality)
+{
+    PropertyTree one = json(R"({"a":[1,2,{"b":"c"}],"d":1.5})");
+    PropertyTree two = json(R"({"d":1.5,"a":[1,2,{"b":"c"}]})");
+    EXPECT_EQ(one.hash(), two.hash());
+    EXPECT_EQ(PropertyTreeScalar(-0.0).hash(), PropertyTreeScalar(0.0).hash());
+
+    const std::unordered_set<PropertyTree> unique{ one, two, json("[1]") };
+    EXPECT_EQ(unique.size(), 2u);
+
+    two["d"] = PropertyTreeScalar(2.5);
+    EXPECT_NE(one.hash(), two.hash());
+}
+
+TEST(PropertyTreeDiffTest, HashCacheIsReset)
+{
+    PropertyTree list;
+    list.append(PropertyTreeScalar(1));
+    PropertyTree tree;
+    tree.insert("a", list);
+    const uint64_t before = tree.hash();
+    EXPECT_EQ(before, json(R"({"a":[1]})").hash());
+
+    PropertyTree copy = tree;
+    EXPECT_EQ(copy.hash(), before);
+    copy.insert("b", PropertyTreeScalar(2));
+    EXPECT_EQ(copy.hash(), json(R"({"a":[1],"b":2})").hash());
+    EXPECT_EQ(tree.hash(), before);
+
+    // reference taken after the hash was computed.
+    auto& map = tree.getMap();
+    map["a"].append(PropertyTreeScalar(2));
+    EXPECT_EQ(tree.hash(), json(R"({"a":[1,2]})").hash());
+    map["a"] = PropertyTreeScalar(3);
+    EXPECT_EQ(tree.hash(), json(R"({"a":3})").hash());
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/PropertyTree.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace Mernel {
+
+TEST(PropertyTreeKeyTest, AtomsAreShared)
+{
+    const PropertyTreeKey a = PropertyTreeKey::intern("field");
+    const PropertyTreeKey b = PropertyTreeKey::intern(std::string("fie") + "ld");
+    const PropertyTreeKey c("field");
+
+    EXPECT_TRUE(a.isAtom());
+    EXPECT_FALSE(c.isAtom());
+    EXPECT_EQ(&a.str(), &b.str());
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a, c);
+    EXPECT_EQ(a, "field");
+    EXPECT_LT(a, PropertyTreeKey::intern("fields"));
+}
+
+TEST(PropertyTreeKeyTest, LookupByAtom)
+{
+    const PropertyTreeKey id   = PropertyTreeKey::intern("id");
+    const PropertyTreeKey name = PropertyTreeKey::intern("name");
+
+    PropertyTree tree;
+    tree["name"] = PropertyTreeScalar("x");
+    tree[id]     = PropertyTreeScalar(5);
+
+    EXPECT_TRUE(tree.contains(id));
+    EXPECT_TRUE(tree.contains(name));
+    EXPECT_FALSE(tree.contains(PropertyTreeKey::intern("missing")));
+    EXPECT_EQ(tree[name].getScalar().toString(), "x");
+    EXPECT_EQ(tree.value(id, PropertyTreeScalar(0)).toInt(), 5);
+    EXPECT_EQ(tree.find(PropertyTreeKey::intern("missing")), nullptr);
+}
+
+}
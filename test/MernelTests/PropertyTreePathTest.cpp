@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/FileFormatJson.hpp"
+#include "MernelPlatform/PropertyTreePath.hpp"
+
+#include <gtest/gtest.h>
+
+namespace Mernel {
+
+namespace {
+
+const PropertyTree& document()
+{
+    static const PropertyTree s_document = readJsonFromBuffer(R"({"foo":["bar","baz"],"":0,"a/b":1,"c%d":2," ":7,"m~n":8,)"
+                                                              R"("list":[{"p":1},{"p":2},{"q":3}],"0":"zero","*":9})");
+    return s_document;
+}
+
+const PropertyTree* pointer(std::string_view path)
+{
+    return PropertyTreePath::fromPointer(path).resolve(document());
+}
+
+}
+
+TEST(PropertyTreePathTest, PointerRfc6901)
+{
+    EXPECT_EQ(pointer(""), &document());
+    ASSERT_NE(pointer("/foo"), nullptr);
+    EXPECT_TRUE(pointer("/foo")->isList());
+    EXPECT_EQ(pointer("/foo/0")->getScalar().toStringView(), "bar");
+    EXPECT_EQ(pointer("/")->getScalar().toInt(), 0);
+    EXPECT_EQ(pointer("/a~1b")->getScalar().toInt(), 1);
+    EXPECT_EQ(pointer("/m~0n")->getScalar().toInt(), 8);
+    EXPECT_EQ(pointer("/ ")->getScalar().toInt(), 7);
+    EXPECT_EQ(pointer("/0")->getScalar().toStringView(), "zero");
+    EXPECT_EQ(pointer("/*")->getScalar().toInt(), 9);
+    EXPECT_EQ(pointer("/list/*/p"), nullptr);
+    EXPECT_FALSE(PropertyTreePath::fromPointer("/list/*/p").hasWildcards());
+
+    EXPECT_EQ(pointer("/foo/01"), nullptr);
+    EXPECT_EQ(pointer("/foo/2"), nullptr);
+    EXPECT_EQ(pointer("/foo/-"), nullptr);
+    EXPECT_EQ(pointer("/nope/x"), nullptr);
+
+    EXPECT_THROW(PropertyTreePath::fromPointer("x"), std::runtime_error);
+    EXPECT_THROW(PropertyTreePath::fromPointer("/a~2"), std::runtime_error);
+    EXPECT_EQ(PropertyTreePath::fromPointer("/m~0n/a~1b").toPointer(), "/m~0n/a~1b");
+}
+
+TEST(PropertyTreePathTest, DottedWildcards)
+{
+    std::vector<const PropertyTree*> all;
+    PropertyTreePath::fromDotted("list.*.p").resolveAll(document(), all);
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(all[0]->getScalar().toInt(), 1);
+    EXPECT_EQ(all[1]->getScalar().toInt(), 2);
+
+    EXPECT_EQ(PropertyTreePath::fromDotted("list.*.q").resolve(document())->getScalar().toInt(), 3);
+    EXPECT_EQ(PropertyTreePath::fromDotted("foo.1").resolve(document())->getScalar().toStringView(), "baz");
+}
+
+TEST(PropertyTreePathTest, PointerPattern)
+{
+    const PropertyTreePath pattern = PropertyTreePath::fromPointerPattern("/list/*/p");
+    EXPECT_TRUE(pattern.hasWildcards());
+    EXPECT_EQ(pattern.resolve(document())->getScalar().toInt(), 1);
+    EXPECT_EQ(PropertyTreePath::fromPointerPattern(pattern.toPointer()).resolve(document()), pattern.resolve(document()));
+
+    size_t count = 0;
+    pattern.forEach(document(), [&count](const PropertyTree&) { ++count; });
+    EXPECT_EQ(count, 2u);
+
+    EXPECT_EQ(PropertyTreePath::fromPointerPattern("/list/*/r").resolve(document()), nullptr);
+    EXPECT_EQ(PropertyTreePath::fromPointerPattern("/*/1").resolve(document())->getScalar().toStringView(), "baz");
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/PropertyTree.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace Mernel {
+
+TEST(PropertyTreeScalarTest, Layout)
+{
+    EXPECT_EQ(sizeof(PropertyTreeScalar), 16u);
+
+    EXPECT_TRUE(PropertyTreeScalar().isNull());
+    EXPECT_TRUE(PropertyTreeScalar(true).isBool());
+    EXPECT_EQ(PropertyTreeScalar(-5).toInt(), -5);
+    EXPECT_EQ(PropertyTreeScalar(2.5).toDouble(), 2.5);
+    EXPECT_EQ(PropertyTreeScalar(2.5).toInt(), 2);
+}
+
+TEST(PropertyTreeScalarTest, InlineAndHeapStrings)
+{
+    const std::string shortStr = "thirteen char";
+    const std::string longStr  = "fourteen chars";
+    ASSERT_EQ(shortStr.size(), 13u);
+
+    for (const std::string& str : { std::string(), shortStr, longStr, std::string(1000, 'x') }) {
+        const PropertyTreeScalar scalar(str);
+        EXPECT_TRUE(scalar.isString());
+        EXPECT_EQ(scalar.toStringView(), str);
+        EXPECT_EQ(scalar.toString(), str);
+        EXPECT_EQ(std::string(scalar.toCString()), str);
+
+        PropertyTreeScalar copy = scalar;
+        EXPECT_EQ(copy, scalar);
+        PropertyTreeScalar moved = std::move(copy);
+        EXPECT_EQ(moved, scalar);
+    }
+    EXPECT_NE(PropertyTreeScalar(shortStr), PropertyTreeScalar(longStr));
+}
+
+TEST(PropertyTreeScalarTest, BorrowedStrings)
+{
+    const std::string        source = "borrowed string value";
+    const PropertyTreeScalar borrowed = PropertyTreeScalar::borrowed(source);
+    EXPECT_TRUE(borrowed.isBorrowed());
+    EXPECT_EQ(borrowed.toStringView().data(), source.data());
+    EXPECT_EQ(borrowed, PropertyTreeScalar(source));
+
+    const PropertyTreeScalar copy = borrowed;
+    EXPECT_FALSE(copy.isBorrowed());
+    EXPECT_NE(copy.toStringView().data(), source.data());
+    EXPECT_EQ(copy, borrowed);
+
+    PropertyTreeScalar       temp  = PropertyTreeScalar::borrowed(source);
+    const PropertyTreeScalar moved = std::move(temp);
+    EXPECT_TRUE(moved.isBorrowed());
+    EXPECT_EQ(moved.toStringView().data(), source.data());
+}
+
+}
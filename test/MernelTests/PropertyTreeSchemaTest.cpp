@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "MernelPlatform/FileFormatJson.hpp"
+#include "MernelPlatform/PropertyTreeSchema.hpp"
+
+#include <gtest/gtest.h>
+
+namespace Mernel {
+
+namespace {
+
+const PropertyTreeSchema& schema()
+{
+    static const PropertyTreeSchema s_schema = PropertyTreeSchema::compile(readJsonFromBuffer(
+        R"({"type":"object","required":["a/b","x"],"properties":{"x":{"type":["string","null"],"minLength":2,"maxLength":3},)"
+        R"("n":{"type":"number","minimum":-1.5,"maximum":9007199254740993},"e":{"enum":[1,"q",null]},)"
+        R"("l":{"type":"array","items":{"type":"integer"}}}})"));
+    return s_schema;
+}
+
+}
+
+TEST(PropertyTreeSchemaTest, Valid)
+{
+    PropertyTreeSchema::ErrorList errors;
+    EXPECT_TRUE(schema().validate(readJsonFromBuffer(R"({"x":"ééé","n":9007199254740992,"e":null,"a/b":0,"l":[1,2]})"), errors));
+    EXPECT_TRUE(errors.empty());
+    EXPECT_TRUE(schema().isValid(readJsonFromBuffer(R"({"x":null,"n":3,"a/b":0})")));
+    EXPECT_TRUE(PropertyTreeSchema().isValid(readJsonFromBuffer(R"([1,"x"])")));
+}
+
+TEST(PropertyTreeSchemaTest, Errors)
+{
+    PropertyTreeSchema::ErrorList errors;
+    EXPECT_FALSE(schema().validate(readJsonFromBuffer(R"({"x":"éééé","n":-2,"e":"z","l":[1,1.5]})"), errors));
+    EXPECT_EQ(errors.size(), 5u);
+    EXPECT_FALSE(schema().isValid(readJsonFromBuffer(R"({"x":null,"n":true,"a/b":0})")));
+    EXPECT_FALSE(schema().isValid(readJsonFromBuffer(R"([])")));
+}
+
+TEST(PropertyTreeSchemaTest, InvalidSchemaThrows)
+{
+    EXPECT_THROW(PropertyTreeSchema::compile(readJsonFromBuffer(R"({"type":"foo"})")), std::runtime_error);
+}
+
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#include "TestTypes.hpp"
+
+#include "MernelPlatform/FileFormatJson.hpp"
+#include "MernelReflection/JsonCursorReader.hpp"
+#include "MernelReflection/JsonTextWriter.hpp"
+#include "MernelReflection/PropertyTreeReader.hpp"
+#include "MernelReflection/PropertyTreeSchemaGenerator.hpp"
+#include "MernelReflection/PropertyTreeWriter.hpp"
+
+#include <gtest/gtest.h>
+
+namespace Mernel {
+
+namespace TestData {
+// not reflected: only custom readers and writers below know how to convert it.
+struct Tag {
+    std::string m_value;
+
+    auto operator<=>(const Tag&) const = default;
+};
+using TagMap = std::map<Tag, int>;
+}
+
+namespace Reflection {
+template<>
+[[maybe_unused]] inline constexpr const bool s_isStringMap<TestData::TagMap>{ true };
+}
+
+using TestData::Inner;
+using TestData::Outer;
+
+namespace {
+
+class TagCursorReader : public Reflection::JsonCursorReaderBase<TagCursorReader> {
+public:
+    void jsonToValueImpl(JsonCursor& cursor, TestData::Tag& value) { value.m_value = "#" + cursor.readScalar().toString(); }
+    void jsonToValueImpl(const PropertyTree& json, TestData::Tag& value) { value.m_value = "#" + json.getScalar().toString(); }
+};
+
+class TagTextWriter : public Reflection::JsonTextWriterBase<TagTextWriter> {
+public:
+    void valueToJsonImpl(const TestData::Tag& value, JsonEmitter& out) { out.writeString(value.m_value.substr(1)); }
+    void valueToJsonImpl(const TestData::Tag& value, PropertyTree& result) { result = PropertyTreeScalar(value.m_value.substr(1)); }
+};
+
+}
+
+TEST(ReflectionTest, PropertyTreeRoundTrip)
+{
+    const Outer reference = TestData::makeOuter(50);
+
+    PropertyTree tree;
+    Reflection::PropertyTreeWriter().valueToJson(reference, tree);
+    EXPECT_EQ(std::as_const(tree)["color"].getScalar().toStringView(), "Green");
+
+    Outer result;
+    Reflection::PropertyTreeReader().jsonToValue(tree, result);
+    EXPECT_EQ(result, reference);
+
+    Outer fromText;
+    Reflection::PropertyTreeReader().jsonToValue(readJsonFromBuffer(writeJsonToBuffer(tree)), fromText);
+    EXPECT_EQ(fromText, reference);
+}
+
+TEST(ReflectionTest, TextWriterMatchesTreeWriter)
+{
+    for (const Outer& value : { Outer{}, TestData::makeOuter(0), TestData::makeOuter(50) }) {
+        PropertyTree tree;
+        Reflection::PropertyTreeWriter().valueToJson(value, tree);
+        EXPECT_EQ(Reflection::JsonTextWriter().writeToBuffer(value), writeJsonToBuffer(tree));
+    }
+}
+
+TEST(ReflectionTest, CursorReaderMatchesTreeReader)
+{
+    const Outer       reference = TestData::makeOuter(50);
+    const std::string buffer    = Reflection::JsonTextWriter().writeToBuffer(reference);
+
+    Outer result;
+    Reflection::JsonCursorReader().readFromBuffer(buffer, result);
+    EXPECT_EQ(result, reference);
+
+    // missing fields are reset to default, unknown ones are skipped.
+    Inner inner{ 5, "y", { 1 }, 1.f };
+    Reflection::JsonCursorReader().readFromBuffer(R"({"id":7,"unknown":[1,{"a":2}]})", inner);
+    EXPECT_EQ(inner, (Inner{ 7, "x", {}, 0.f }));
+
+    // map entries need both key and value, same as for PropertyTreeReader.
+    for (const char* text : { R"({"names":[{"key":1}]})", R"({"names":[{"value":"a"}]})" }) {
+        Outer cursorResult, treeResult;
+        EXPECT_THROW(Reflection::JsonCursorReader().readFromBuffer(text, cursorResult), std::out_of_range);
+        EXPECT_THROW(Reflection::PropertyTreeReader().jsonToValue(readJsonFromBuffer(text), treeResult), std::out_of_range);
+    }
+}
+
+TEST(ReflectionTest, CursorReaderForwardsTreeReadsToCustomReader)
+{
+    // string map keys are converted through a PropertyTree scalar, which still goes to the custom reader.
+    TestData::TagMap map;
+    TagCursorReader().readFromBuffer(R"({"b":2,"a":1})", map);
+    EXPECT_EQ(map, (TestData::TagMap{ { { "#a" }, 1 }, { { "#b" }, 2 } }));
+
+    std::vector<TestData::Tag> list;
+    TagCursorReader().readFromBuffer(R"(["x"])", list);
+    ASSERT_EQ(list.size(), 1u);
+    EXPECT_EQ(list[0].m_value, "#x");
+}
+
+TEST(ReflectionTest, TextWriterForwardsTreeWritesToCustomWriter)
+{
+    const TestData::TagMap map{ { { "#b" }, 2 }, { { "#a" }, 1 } };
+    EXPECT_EQ(TagTextWriter().writeToBuffer(map), R"({"a":1,"b":2})");
+
+    const std::vector<TestData::Tag> list{ { "#x" } };
+    EXPECT_EQ(TagTextWriter().writeToBuffer(list), R"(["x"])");
+}
+
+TEST(ReflectionTest, SchemaGenerator)
+{
+    const PropertyTreeSchema validator = Reflection::PropertyTreeSchemaGenerator().makeValidator<Outer>();
+
+    PropertyTree tree;
+    Reflection::PropertyTreeWriter().valueToJson(TestData::makeOuter(5), tree);
+    PropertyTreeSchema::ErrorList errors;
+    EXPECT_TRUE(validator.validate(tree, errors));
+    EXPECT_TRUE(errors.empty());
+
+    EXPECT_FALSE(validator.isValid(readJsonFromBuffer(R"({"color":"Purple"})")));
+    EXPECT_FALSE(validator.isValid(readJsonFromBuffer(R"({"inner":{"id":"x"}})")));
+    EXPECT_FALSE(validator.isValid(readJsonFromBuffer(R"({"list":[{"weights":[true]}]})")));
+
+    // unknown keys are ignored by reader, so only strict validator rejects them.
+    const PropertyTree unknownKey = readJsonFromBuffer(R"({"color":"Green","unknown":1})");
+    EXPECT_TRUE(validator.isValid(unknownKey));
+
+    Reflection::PropertyTreeSchemaGenerator strict;
+    strict.m_additionalProperties = false;
+    EXPECT_FALSE(strict.makeValidator<Outer>().isValid(unknownKey));
+    EXPECT_TRUE(strict.makeValidator<Outer>().isValid(tree));
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2024 Smirnov Vladimir / mapron1@gmail.com
+ * SPDX-License-Identifier: MIT
+ * See LICENSE file for details.
+ */
+#pragma once
+
+#include "MernelReflection/EnumTraitsMacro.hpp"
+#include "MernelReflection/MetaInfoMacro.hpp"
+
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Mernel::TestData {
+
+enum class Color
+{
+    Red,
+    Green,
+    Blue,
+};
+
+struct Inner {
+    int                 m_id = 1;
+    std::string         m_name{ "x" };
+    std::vector<double> m_weights;
+    float               m_scale = 0.f;
+
+    bool operator==(const Inner&) const = default;
+};
+
+struct Outer {
+    Inner                      m_inner;
+    std::map<std::string, int> m_counters;
+    std::map<int, std::string> m_names;
+    std::optional<int>         m_optional;
+    Color                      m_color = Color::Red;
+    std::vector<Inner>         m_list;
+    std::set<int>              m_set;
+    bool                       m_flag = false;
+
+    bool operator==(const Outer&) const = default;
+};
+
+inline Outer makeOuter(int listSize)
+{
+    Outer outer;
+    outer.m_inner.m_weights   = { 1.5, 2, -0.125 };
+    outer.m_counters["k"]     = 3;
+    outer.m_counters["a\"\n"] = 1;
+    outer.m_names[3]          = "three";
+    outer.m_optional          = 5;
+    outer.m_color             = Color::Green;
+    outer.m_set               = { 3, 1 };
+    outer.m_flag              = true;
+    for (int i = 0; i < listSize; ++i)
+        outer.m_list.push_back(Inner{ i, "name number " + std::to_string(i), { i * 0.5, 1.0 }, 0.25f });
+    return outer;
+}
+
+}
+
+namespace Mernel::Reflection {
+ENUM_REFLECTION_STRINGIFY(TestData::Color, Red, Red, Green, Blue)
+STRUCT_REFLECTION_STRINGIFY_OFFSET_2(TestData::Inner, m_id, m_name, m_weights, m_scale)
+STRUCT_REFLECTION_STRINGIFY_OFFSET_2(TestData::Outer, m_inner, m_counters, m_names, m_optional, m_color, m_list, m_set, m_flag)
+}